@@ -0,0 +1,128 @@
+// 基准测试框架 - 为各条款中的性能结论提供可测量的数据
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/*
+    用法：
+        Bench::run("item05/auto-closure", [&] { ... 一次操作 ... });
+
+    * run会自动调节迭代次数，使总耗时不少于minTime，然后输出
+        ns/op      每次操作的平均耗时
+        allocs/op  每次操作的平均堆分配次数
+        bytes/op   每次操作的平均堆分配字节数
+    * 分配统计来自bench_main.cpp中替换的全局operator new，所有线程都会被统计
+    * 若一次body调用完成了多次操作（如一次遍历整个容器），通过opsPerCall告知run
+*/
+
+namespace Bench
+{
+    // 全局堆分配计数，由替换的operator new累加（relaxed即可，只在测量前后读取）
+    struct AllocCounter
+    {
+        std::atomic<std::uint64_t> count{ 0 };
+        std::atomic<std::uint64_t> bytes{ 0 };
+    };
+
+    AllocCounter& allocCounter();
+
+    struct Result
+    {
+        std::uint64_t ops = 0;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+        double bytesPerOp = 0.0;
+    };
+
+    // 每个基准测试的最短运行时间
+    inline std::chrono::nanoseconds minTime{ std::chrono::milliseconds(200) };
+
+    // 阻止编译器把基准测试中的计算当作无用代码删除
+    template<typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // 强制编译器认为所有内存都可能被读写
+    inline void clobberMemory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    void section(const char* title);
+
+    void report(const char* name, const Result& result);
+
+    template<typename F>
+    Result run(const char* name, F&& body, std::uint64_t opsPerCall = 1)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        body();     // 预热（填充缓存、首次分配等）
+
+        auto& counter = allocCounter();
+        std::uint64_t iterations = 1;
+        for (;;) {
+            auto count0 = counter.count.load(std::memory_order_relaxed);
+            auto bytes0 = counter.bytes.load(std::memory_order_relaxed);
+            auto start = Clock::now();
+
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                body();
+            }
+
+            auto elapsed = Clock::now() - start;
+            auto count1 = counter.count.load(std::memory_order_relaxed);
+            auto bytes1 = counter.bytes.load(std::memory_order_relaxed);
+
+            if (elapsed >= minTime || iterations >= (std::uint64_t(1) << 40)) {
+                Result result;
+                result.ops = iterations * opsPerCall;
+                auto ops = static_cast<double>(result.ops);
+                result.nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+                result.allocsPerOp = static_cast<double>(count1 - count0) / ops;
+                result.bytesPerOp = static_cast<double>(bytes1 - bytes0) / ops;
+                report(name, result);
+                return result;
+            }
+
+            // 按上一轮的耗时估算下一轮的迭代次数，至多放大10倍
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            auto target = static_cast<double>(minTime.count()) * 1.2;
+            auto scale = ns > 0 ? target / static_cast<double>(ns) : 10.0;
+            if (scale > 10.0) scale = 10.0;
+            if (scale < 2.0) scale = 2.0;
+            iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * scale);
+        }
+    }
+}
+
+// 各条款的基准测试入口，定义于bench_itemXX.cpp
+void benchItem01();
+void benchItem02();
+void benchItem03();
+void benchItem04();
+void benchItem05();
+void benchItem06();
+void benchItem07();
+void benchItem08();
+void benchItem10();
+void benchItem12();
+void benchItem13();
+void benchItem14();
+void benchItem15();
+void benchItem16();
@@ -0,0 +1,174 @@
+// 条款1 - 理解模板型别推导（Chapter01/item01_perfect_hash.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter01/item01_fixed_search.hpp"
+#include "Chapter01/item01_perfect_hash.hpp"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using Item01_PerfectHash::makePerfectHashMap;
+
+    // 与TempalteTypeDedution7::test2相同的键
+    constexpr int keyVals[] = { 1, 3, 7, 9, 11, 22, 35 };
+    constexpr int mappedVals[] = { 10, 30, 70, 90, 110, 220, 350 };
+
+    // 64项的路由表，键有序（lower_bound要求有序）
+    constexpr int routeKeys[] = {
+        3, 10, 31, 66, 115, 178, 255, 346,
+        451, 570, 703, 850, 1011, 1186, 1375, 1578,
+        1795, 2026, 2271, 2530, 2803, 3090, 3391, 3706,
+        4035, 4378, 4735, 5106, 5491, 5890, 6303, 6730,
+        7171, 7626, 8095, 8578, 9075, 9586, 10111, 10650,
+        11203, 11770, 12351, 12946, 13555, 14178, 14815, 15466,
+        16131, 16810, 17503, 18210, 18931, 19666, 20415, 21178,
+        21955, 22746, 23551, 24370, 25203, 26050, 26911, 27786,
+    };
+
+    template<std::size_t N>
+    std::vector<int> makeQueries(const int (&keys)[N], int missPercent)
+    {
+        std::mt19937 rng(1);
+        std::vector<int> queries(1024);
+        for (auto& q : queries) {
+            q = static_cast<int>(rng() % 100) < missPercent
+                ? -static_cast<int>(rng() % 1000) - 1           // 所有键都是正数，负数必然未命中
+                : keys[rng() % N];
+        }
+        return queries;
+    }
+
+    template<std::size_t N, typename Map>
+    void compare(const char* label, const int (&keys)[N], const int (&values)[N],
+                 const Map& perfect, int missPercent)
+    {
+        std::unordered_map<int, int> hashed;
+        for (std::size_t i = 0; i < N; ++i) hashed.emplace(keys[i], values[i]);
+
+        auto queries = makeQueries(keys, missPercent);
+        char name[96];
+
+        std::snprintf(name, sizeof(name), "item01/%s PerfectHashMap::lookup", label);
+        Bench::run(name, [&] {
+            int sum = 0;
+            for (int q : queries) sum += perfect.lookup(q, 0);
+            Bench::doNotOptimize(sum);
+        }, queries.size());
+
+        std::snprintf(name, sizeof(name), "item01/%s std::unordered_map::find", label);
+        Bench::run(name, [&] {
+            int sum = 0;
+            for (int q : queries) {
+                auto it = hashed.find(q);
+                sum += it != hashed.end() ? it->second : 0;
+            }
+            Bench::doNotOptimize(sum);
+        }, queries.size());
+
+        std::snprintf(name, sizeof(name), "item01/%s std::lower_bound", label);
+        Bench::run(name, [&] {
+            int sum = 0;
+            for (int q : queries) {
+                auto it = std::lower_bound(std::begin(keys), std::end(keys), q);
+                sum += (it != std::end(keys) && *it == q) ? values[it - std::begin(keys)] : 0;
+            }
+            Bench::doNotOptimize(sum);
+        }, queries.size());
+    }
+
+    void lookup()
+    {
+        static constexpr auto small = makePerfectHashMap(keyVals, mappedVals);
+        compare("7 keys, hit", keyVals, mappedVals, small, 0);
+        compare("7 keys, 50% miss", keyVals, mappedVals, small, 50);
+
+        static constexpr auto routes = makePerfectHashMap(routeKeys);
+        int routeValues[64];
+        for (int i = 0; i < 64; ++i) routeValues[i] = i;
+
+        // PerfectHashMap映射到下标，这里统一返回int以便比较
+        struct IndexAdapter
+        {
+            int lookup(int key, int fallback) const
+            {
+                return static_cast<int>(routes.lookup(key, static_cast<std::size_t>(fallback)));
+            }
+        };
+        compare("64 keys, hit", routeKeys, routeValues, IndexAdapter{}, 0);
+        compare("64 keys, 50% miss", routeKeys, routeValues, IndexAdapter{}, 50);
+    }
+    // 定长查找：std::find逐元素比较并分支，Item01_FixedSearch按N展开成向量比较
+    template<typename T, std::size_t N>
+    void fixedSearch(const char* label)
+    {
+        T table[N];
+        for (std::size_t i = 0; i < N; ++i) table[i] = static_cast<T>(i * 3 + 1);
+
+        // 一半命中（位置均匀分布），一半未命中
+        std::mt19937 rng(2);
+        std::vector<T> needles(1024);
+        for (auto& n : needles) n = static_cast<T>((rng() % (2 * N)) * 3 + 1 + (rng() % 2));
+
+        char name[96];
+
+        std::snprintf(name, sizeof(name), "item01/%s std::find", label);
+        Bench::run(name, [&] {
+            std::size_t sum = 0;
+            for (T n : needles) sum += static_cast<std::size_t>(std::find(table, table + N, n) - table);
+            Bench::doNotOptimize(sum);
+        }, needles.size());
+
+        std::snprintf(name, sizeof(name), "item01/%s FixedSearch::find", label);
+        Bench::run(name, [&] {
+            std::size_t sum = 0;
+            for (T n : needles) sum += Item01_FixedSearch::find(table, n);
+            Bench::doNotOptimize(sum);
+        }, needles.size());
+
+        std::snprintf(name, sizeof(name), "item01/%s std::count", label);
+        Bench::run(name, [&] {
+            std::size_t sum = 0;
+            for (T n : needles) sum += static_cast<std::size_t>(std::count(table, table + N, n));
+            Bench::doNotOptimize(sum);
+        }, needles.size());
+
+        std::snprintf(name, sizeof(name), "item01/%s FixedSearch::count", label);
+        Bench::run(name, [&] {
+            std::size_t sum = 0;
+            for (T n : needles) sum += Item01_FixedSearch::count(table, n);
+            Bench::doNotOptimize(sum);
+        }, needles.size());
+
+        std::snprintf(name, sizeof(name), "item01/%s std::min_element", label);
+        Bench::run(name, [&] {
+            Bench::clobberMemory();
+            auto m = *std::min_element(table, table + N);
+            Bench::doNotOptimize(m);
+        });
+
+        std::snprintf(name, sizeof(name), "item01/%s FixedSearch::min", label);
+        Bench::run(name, [&] {
+            Bench::clobberMemory();
+            auto m = Item01_FixedSearch::min(table);
+            Bench::doNotOptimize(m);
+        });
+    }
+}
+
+void benchItem01()
+{
+    Bench::section("item01 - perfect hash over arraySize-deduced keys");
+    lookup();
+
+    Bench::section("item01 - fixed-size search over T (&)[N]");
+    fixedSearch<int, 8>("int[8]");
+    fixedSearch<int, 16>("int[16]");
+    fixedSearch<int, 32>("int[32]");
+    fixedSearch<int, 64>("int[64]");
+    fixedSearch<std::uint8_t, 64>("uint8_t[64]");
+}
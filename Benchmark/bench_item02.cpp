@@ -0,0 +1,97 @@
+// 条款2 - 理解auto型别推导（Chapter01/item02_small_vector.hpp、item02_make_container.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter01/item02_make_container.hpp"
+#include "Chapter01/item02_small_vector.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Item02_SmallVector::small_vector;
+
+    // 用index_sequence生成 { 0, 1, ..., N-1 } 这样的花括号列表，长度在编译期确定
+    template<typename Container, std::size_t... I>
+    void braceInit(const char* name, std::index_sequence<I...>)
+    {
+        Bench::run(name, [] {
+            Container v{ static_cast<int>(I)... };
+            Bench::doNotOptimize(v.data());
+        });
+    }
+
+    // TestLambdaAuto中的 v = { 1, 2, 3 }：对一个新容器做列表赋值
+    template<typename Container, std::size_t... I>
+    void braceAssign(const char* name, std::index_sequence<I...>)
+    {
+        Bench::run(name, [] {
+            Container v;
+            v = { static_cast<int>(I)... };
+            Bench::doNotOptimize(v.data());
+        });
+    }
+
+    template<std::size_t N>
+    void listOf()
+    {
+        char name[96];
+
+        std::snprintf(name, sizeof(name), "item02/%2zu ints, std::vector{...}", N);
+        braceInit<std::vector<int>>(name, std::make_index_sequence<N>());
+
+        std::snprintf(name, sizeof(name), "item02/%2zu ints, small_vector<int, 8>{...}", N);
+        braceInit<small_vector<int, 8>>(name, std::make_index_sequence<N>());
+
+        std::snprintf(name, sizeof(name), "item02/%2zu ints, small_vector<int, 16>{...}", N);
+        braceInit<small_vector<int, 16>>(name, std::make_index_sequence<N>());
+
+        std::snprintf(name, sizeof(name), "item02/%2zu ints, std::vector v = {...}", N);
+        braceAssign<std::vector<int>>(name, std::make_index_sequence<N>());
+
+        std::snprintf(name, sizeof(name), "item02/%2zu ints, small_vector<int, 8> v = {...}", N);
+        braceAssign<small_vector<int, 8>>(name, std::make_index_sequence<N>());
+    }
+
+    // 花括号初始化：8个长字符串先构造进initializer_list，再逐个拷贝进vector
+    // make_container：同样的8个临时字符串被移动进vector，并且只reserve一次
+    void longStrings()
+    {
+        const char* text = "a string that is much longer than the small string buffer of std::string";
+
+        Bench::run("item02/vector<string>{8 long strings}", [&] {
+            std::vector<std::string> v{ std::string(text), std::string(text), std::string(text), std::string(text),
+                                        std::string(text), std::string(text), std::string(text), std::string(text) };
+            Bench::doNotOptimize(v.data());
+        });
+
+        Bench::run("item02/make_container<vector<string>>(8 long)", [&] {
+            auto v = Item02_MakeContainer::make_container<std::vector<std::string>>(
+                std::string(text), std::string(text), std::string(text), std::string(text),
+                std::string(text), std::string(text), std::string(text), std::string(text));
+            Bench::doNotOptimize(v.data());
+        });
+
+        Bench::run("item02/make_container<vector<string>>(8 char*)", [&] {
+            auto v = Item02_MakeContainer::make_container<std::vector<std::string>>(
+                text, text, text, text, text, text, text, text);
+            Bench::doNotOptimize(v.data());
+        });
+    }
+}
+
+void benchItem02()
+{
+    Bench::section("item02 - brace-initialised short lists");
+    listOf<1>();
+    listOf<2>();
+    listOf<4>();
+    listOf<8>();
+    listOf<12>();
+    listOf<16>();
+
+    Bench::section("item02 - move-capable list construction");
+    longStrings();
+}
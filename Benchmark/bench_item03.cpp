@@ -0,0 +1,135 @@
+// 条款3 - 理解decltype（Chapter01/item03_gather.hpp、item03_take.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter01/item03_gather.hpp"
+#include "Chapter01/item03_take.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Item03_Gather::getValues;
+
+    // 与item03.hpp中DecltypeDeductions5::getValue相同
+    template<typename Container, typename Index>
+    decltype(auto) getValue(Container&& c, Index i)
+    {
+        return std::forward<Container>(c)[i];
+    }
+
+    // 容器远大于末级缓存（16M个元素），下标随机，每批4096个
+    constexpr std::size_t ElementCount = std::size_t(1) << 24;
+    constexpr std::size_t BatchSize = 4096;
+
+    template<typename Index>
+    std::vector<Index> makeBatch(std::uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<Index> indices(BatchSize);
+        for (auto& i : indices) i = static_cast<Index>(rng() % ElementCount);
+        return indices;
+    }
+
+    // 准备若干批不同的下标轮流使用，避免同一批下标反复访问后常驻缓存
+    template<typename Index>
+    std::vector<std::vector<Index>> makeBatches()
+    {
+        std::vector<std::vector<Index>> batches;
+        for (std::uint32_t s = 0; s < 64; ++s) batches.push_back(makeBatch<Index>(s + 1));
+        return batches;
+    }
+
+    template<typename Container, typename Index>
+    void gather(const char* loopName, const char* batchName, const Container& c)
+    {
+        using T = typename Container::value_type;
+        const auto batches = makeBatches<Index>();
+        std::vector<T> out(BatchSize);
+        std::size_t b = 0;
+
+        Bench::run(loopName, [&] {
+            const auto& indices = batches[b++ % batches.size()];
+            for (std::size_t k = 0; k < indices.size(); ++k) out[k] = getValue(c, indices[k]);
+            Bench::doNotOptimize(out.data());
+            Bench::clobberMemory();
+        }, BatchSize);
+
+        Bench::run(batchName, [&] {
+            getValues(c, batches[b++ % batches.size()], out.begin());
+            Bench::doNotOptimize(out.data());
+            Bench::clobberMemory();
+        }, BatchSize);
+    }
+
+    // 两种操作都从prototype拷贝出一个"即将销毁的临时容器"，这部分分配两边相同；
+    // 差别只在取出元素时是拷贝还是移动
+    template<typename T>
+    void consume(const char* element, const std::vector<T>& prototype)
+    {
+        using Item03_Take::drain;
+        using Item03_Take::take;
+
+        char name[96];
+        std::vector<T> sink;
+        sink.reserve(prototype.size());
+        auto keepEven = [i = std::size_t(0)](const T&) mutable { return i++ % 2 == 0; };
+
+        std::snprintf(name, sizeof(name), "item03/%s getValue(temp, i) copy", element);
+        Bench::run(name, [&] {
+            T e = getValue(std::vector<T>(prototype), 3);
+            Bench::doNotOptimize(e);
+        });
+
+        std::snprintf(name, sizeof(name), "item03/%s take(temp, i)", element);
+        Bench::run(name, [&] {
+            T e = take(std::vector<T>(prototype), 3);
+            Bench::doNotOptimize(e);
+        });
+
+        std::snprintf(name, sizeof(name), "item03/%s copy half into sink", element);
+        Bench::run(name, [&] {
+            std::vector<T> source(prototype);
+            sink.clear();
+            auto pred = keepEven;
+            for (const auto& e : source) {
+                if (pred(e)) sink.push_back(e);
+            }
+            Bench::doNotOptimize(sink.data());
+        });
+
+        std::snprintf(name, sizeof(name), "item03/%s drain half into sink", element);
+        Bench::run(name, [&] {
+            std::vector<T> source(prototype);
+            sink.clear();
+            drain(std::move(source), keepEven, std::back_inserter(sink));
+            Bench::doNotOptimize(sink.data());
+        });
+    }
+}
+
+void benchItem03()
+{
+    std::vector<int> vi(ElementCount);
+    for (std::size_t i = 0; i < vi.size(); ++i) vi[i] = static_cast<int>(i);
+    std::vector<double> vd(vi.begin(), vi.end());
+    std::deque<int> di(vi.begin(), vi.end());
+
+    Bench::section("item03 - batched getValue (16M elements, per index)");
+    gather<std::vector<int>, std::uint32_t>("item03/vector<int> getValue loop (u32)",
+                                             "item03/vector<int> getValues (gather, u32)", vi);
+    gather<std::vector<double>, std::size_t>("item03/vector<double> getValue loop (u64)",
+                                              "item03/vector<double> getValues (gather, u64)", vd);
+    gather<std::deque<int>, std::uint32_t>("item03/deque<int> getValue loop (u32)",
+                                            "item03/deque<int> getValues (prefetch, u32)", di);
+
+    // 16个元素的临时容器；长字符串和vector<int>都在堆上，拷贝一次就是一次分配
+    Bench::section("item03 - consuming extraction from rvalue containers");
+    consume("string", std::vector<std::string>(16, std::string(64, 's')));
+    consume("vector<int>", std::vector<std::vector<int>>(16, std::vector<int>(256, 7)));
+}
@@ -0,0 +1,149 @@
+// 条款4 - 掌握查看类型推导结果的方法（Chapter01/item04_type_name.hpp、item04_trace.hpp、item04_fast_sink.hpp）
+
+#include "bench.hpp"
+
+// 本文件测量TRACE_SCOPE开启时的开销，与Chapter01的编译选项无关
+#define EMCP_TRACE 1
+#include "Chapter01/item04_fast_sink.hpp"
+#include "Chapter01/item04_trace.hpp"
+#include "Chapter01/item04_type_name.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    struct Widget {};
+
+    // 日志里常见的做法：反修饰后放进std::string，再释放__cxa_demangle用malloc分配的缓冲区
+    // （malloc不经过operator new，bytes/op只统计std::string那一次分配）
+    template<typename T>
+    std::string demangled()
+    {
+        int status = 0;
+        char* p = abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status);
+        std::string name = status == 0 ? p : typeid(T).name();
+        std::free(p);
+        return name;
+    }
+
+    template<typename T>
+    void names(const char* label)
+    {
+        char name[96];
+
+        std::snprintf(name, sizeof(name), "item04/%s typeid(T).name()", label);
+        Bench::run(name, [] {
+            const char* n = typeid(T).name();
+            Bench::doNotOptimize(n);
+        });
+
+        std::snprintf(name, sizeof(name), "item04/%s typeid + demangle", label);
+        Bench::run(name, [] {
+            auto n = demangled<T>();
+            Bench::doNotOptimize(n.data());
+        });
+
+        std::snprintf(name, sizeof(name), "item04/%s type_name<T>()", label);
+        Bench::run(name, [] {
+            std::string_view n = Item04_TypeName::type_name<T>();
+            Bench::doNotOptimize(n.data());
+            Bench::doNotOptimize(n.size());
+        });
+    }
+
+    // 每次操作进出一个作用域；对照组只有同样的doNotOptimize
+    void traceScope()
+    {
+        Item04_Trace::setOutput(nullptr);          // 只测写入缓冲区，不在退出时生成文件
+
+        int value = 0;
+        Bench::run("item04/empty scope", [&] {
+            Bench::doNotOptimize(value);
+        });
+
+        Bench::run("item04/TRACE_SCOPE", [&] {
+            TRACE_SCOPE("bench");
+            Bench::doNotOptimize(value);
+        });
+
+        // 时钟本身的开销：TRACE_SCOPE的下限
+        Bench::run("item04/Item04_Trace::now() x2", [&] {
+            auto begin = Item04_Trace::now();
+            Bench::doNotOptimize(value);
+            auto end = Item04_Trace::now();
+            Bench::doNotOptimize(end - begin);
+        });
+
+        Bench::run("item04/steady_clock::now() x2", [&] {
+            auto begin = std::chrono::steady_clock::now();
+            Bench::doNotOptimize(value);
+            auto end = std::chrono::steady_clock::now();
+            Bench::doNotOptimize(end - begin);
+        });
+    }
+
+    // 每次操作输出100万行"行号 整数 浮点数"到/dev/null，ns/op为每行的耗时
+    constexpr std::size_t DumpLines = 1'000'000;
+
+    void dump()
+    {
+        std::ofstream stream("/dev/null");
+        Bench::run("item04/ofstream << ... << std::endl", [&] {
+            for (std::size_t i = 0; i < DumpLines; ++i) {
+                stream << "line " << i << ' ' << static_cast<int>(i * 7) << ' ' << static_cast<double>(i) * 0.25 << std::endl;
+            }
+        }, DumpLines);
+
+        Bench::run("item04/ofstream << ... << '\\n'", [&] {
+            for (std::size_t i = 0; i < DumpLines; ++i) {
+                stream << "line " << i << ' ' << static_cast<int>(i * 7) << ' ' << static_cast<double>(i) * 0.25 << '\n';
+            }
+            stream.flush();
+        }, DumpLines);
+
+        std::FILE* file = std::fopen("/dev/null", "w");
+        Bench::run("item04/fprintf", [&] {
+            for (std::size_t i = 0; i < DumpLines; ++i) {
+                std::fprintf(file, "line %zu %d %g\n", i, static_cast<int>(i * 7), static_cast<double>(i) * 0.25);
+            }
+            std::fflush(file);
+        }, DumpLines);
+        std::fclose(file);
+
+        const int fd = ::open("/dev/null", O_WRONLY);
+        {
+            Item04_FastSink::fast_sink sink(fd);
+            Bench::run("item04/fast_sink.print", [&] {
+                for (std::size_t i = 0; i < DumpLines; ++i) {
+                    sink.print("line {} {} {}\n", i, static_cast<int>(i * 7), static_cast<double>(i) * 0.25);
+                }
+                sink.flush();
+            }, DumpLines);
+        }
+        ::close(fd);
+    }
+}
+
+void benchItem04()
+{
+    Bench::section("item04 - readable type names");
+    names<Widget*>("Widget*");
+    names<std::map<std::string, std::vector<int>>>("map<string,vector<int>>");
+
+    Bench::section("item04 - TRACE_SCOPE overhead");
+    traceScope();
+
+    Bench::section("item04 - million-line dump to /dev/null (per line)");
+    dump();
+}
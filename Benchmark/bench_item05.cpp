@@ -0,0 +1,308 @@
+// 条款5 - 优先选用auto，而非显式类别声明（Chapter02/item05.cpp、item05_dwim.hpp、item05_indirect_sort.hpp、item05_function.hpp、item05_flat_hash_map.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter02/item05_dwim.hpp"
+#include "Chapter02/item05_flat_hash_map.hpp"
+#include "Chapter02/item05_function.hpp"
+#include "Chapter02/item05_indirect_sort.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    class Widget
+    {
+    public:
+        explicit Widget(int v) : value(v) {}
+
+        bool operator<(const Widget& rhs) const { return value < rhs.value; }
+
+    private:
+        int value;
+    };
+
+    std::vector<std::unique_ptr<Widget>> makeWidgets(std::size_t n)
+    {
+        std::mt19937 rng(5);
+        std::vector<std::unique_ptr<Widget>> widgets;
+        widgets.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            widgets.push_back(std::make_unique<Widget>(static_cast<int>(rng())));
+        }
+        return widgets;
+    }
+
+    // 一、test2 - 显式写出pair<std::string, int>会让每次循环都拷贝一个元素
+    void pairCopy()
+    {
+        constexpr std::size_t count = 1000;
+
+        std::unordered_map<std::string, int> m;
+        for (std::size_t i = 0; i < count; ++i) {
+            // 超出SSO长度，拷贝key一定会堆分配
+            m.emplace("widget-key-with-a-long-name-" + std::to_string(i), static_cast<int>(i));
+        }
+
+        Bench::run("item05/for(const pair<string,int>&)", [&] {
+            for (const std::pair<std::string, int>& p : m) {
+                Bench::doNotOptimize(p);
+            }
+        }, count);
+
+        Bench::run("item05/for(const auto&)", [&] {
+            for (const auto& p : m) {
+                Bench::doNotOptimize(p);
+            }
+        }, count);
+    }
+
+    // 二、std::function 与 auto 保存闭包
+    void functionVsAuto()
+    {
+        constexpr std::size_t count = 1000;
+
+        auto source = makeWidgets(count);
+        std::vector<Widget*> order(count);
+
+        auto reset = [&] {
+            for (std::size_t i = 0; i < count; ++i) order[i] = source[i].get();
+        };
+
+        std::function<bool(const Widget*, const Widget*)> derefLessFunc =
+            [](const Widget* p1, const Widget* p2) { return *p1 < *p2; };
+
+        auto derefLess = [](const auto& p1, const auto& p2) { return *p1 < *p2; };
+
+        // 调用开销：以排序为载体，每次比较都经过一次std::function的间接调用
+        Bench::run("item05/sort with std::function", [&] {
+            reset();
+            std::sort(order.begin(), order.end(), derefLessFunc);
+            Bench::doNotOptimize(order.front());
+        }, count);
+
+        Bench::run("item05/sort with auto closure", [&] {
+            reset();
+            std::sort(order.begin(), order.end(), derefLess);
+            Bench::doNotOptimize(order.front());
+        }, count);
+
+        Item05_Function::inplace_function<bool(const Widget*, const Widget*)> derefLessInplace = derefLess;
+        Bench::run("item05/sort with inplace_function", [&] {
+            reset();
+            std::sort(order.begin(), order.end(), derefLessInplace);
+            Bench::doNotOptimize(order.front());
+        }, count);
+
+        // std::sort按值传递比较器；function_ref的拷贝只是两个指针
+        Item05_Function::function_ref<bool(const Widget*, const Widget*)> derefLessRef = derefLess;
+        Bench::run("item05/sort with function_ref", [&] {
+            reset();
+            std::sort(order.begin(), order.end(), derefLessRef);
+            Bench::doNotOptimize(order.front());
+        }, count);
+
+        // 构造开销：闭包超出std::function的内部缓冲区时需要堆分配
+        double a = 1, b = 2, c = 3, d = 4;     // 32字节的捕获，超出libstdc++的16字节缓冲区
+
+        Bench::run("item05/construct std::function (32-byte capture)", [&] {
+            std::function<double()> f = [a, b, c, d] { return a + b + c + d; };
+            Bench::doNotOptimize(f);
+        });
+
+        Bench::run("item05/construct auto closure (32-byte capture)", [&] {
+            auto f = [a, b, c, d] { return a + b + c + d; };
+            Bench::doNotOptimize(f);
+        });
+
+        Bench::run("item05/construct inplace_function<32> (32-byte)", [&] {
+            Item05_Function::inplace_function<double(), 32> f = [a, b, c, d] { return a + b + c + d; };
+            Bench::doNotOptimize(f);
+        });
+
+        Bench::run("item05/construct function_ref (32-byte capture)", [&] {
+            auto closure = [a, b, c, d] { return a + b + c + d; };
+            Item05_Function::function_ref<double()> f = closure;
+            Bench::doNotOptimize(f);
+        });
+    }
+
+    // 三、100万个unique_ptr<Widget>排序：derefLess每次比较都追两个指针，indirect_sort只追一次
+    // Widget按随机顺序分配，每次操作先把指针恢复成同一个乱序排列（"reset only"为这部分的开销）
+    void sortWidgets()
+    {
+        constexpr std::size_t count = 1'000'000;
+
+        auto widgets = makeWidgets(count);
+        std::vector<Widget*> shuffled(count);
+        for (std::size_t i = 0; i < count; ++i) shuffled[i] = widgets[i].get();
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+
+        auto reset = [&] {
+            for (auto& p : widgets) p.release();
+            for (std::size_t i = 0; i < count; ++i) widgets[i].reset(shuffled[i]);
+        };
+
+        auto derefLess = [](const auto& p1, const auto& p2) { return *p1 < *p2; };
+
+        Bench::run("item05/1M widgets, reset only", [&] {
+            reset();
+            Bench::doNotOptimize(widgets.front());
+        }, count);
+
+        Bench::run("item05/1M widgets, std::sort(derefLess)", [&] {
+            reset();
+            std::sort(widgets.begin(), widgets.end(), derefLess);
+            Bench::doNotOptimize(widgets.front());
+        }, count);
+
+        Bench::run("item05/1M widgets, indirect_sort", [&] {
+            reset();
+            Item05_IndirectSort::indirect_sort(widgets);
+            Bench::doNotOptimize(widgets.front());
+        }, count);
+    }
+
+    // 四、dwim：16M个float，分别用访存为主和计算为主的变换，线程数从1到硬件线程数
+    void dwimScaling()
+    {
+        using namespace Item05_Dwim;
+        constexpr std::size_t count = std::size_t(1) << 24;
+
+        std::vector<float> v(count, 1.0f);
+        std::deque<float> d(v.begin(), v.end());
+        auto axpy = [](float x) { return x * 0.999f + 0.001f; };
+        auto heavy = [](float x) { return std::sqrt(x * x + 1.0f) * 0.5f + std::exp(-x) * 0.5f; };
+
+        Bench::run("item05/dwim seq, vector, axpy", [&] {
+            dwim(seq, v.begin(), v.end(), axpy);
+            Bench::clobberMemory();
+        }, count);
+
+        Bench::run("item05/dwim seq, vector, sqrt+exp", [&] {
+            dwim(seq, v.begin(), v.end(), heavy);
+            Bench::clobberMemory();
+        }, count);
+
+        char name[96];
+        const unsigned cores = static_cast<unsigned>(ThreadPool::instance().size());
+        std::vector<unsigned> threadCounts;
+        for (unsigned t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(cores);
+
+        for (unsigned t : threadCounts) {
+            std::snprintf(name, sizeof(name), "item05/dwim par x%u, vector, axpy", t);
+            Bench::run(name, [&] {
+                dwim(par.with(t), v.begin(), v.end(), axpy);
+                Bench::clobberMemory();
+            }, count);
+
+            std::snprintf(name, sizeof(name), "item05/dwim par_unseq x%u, vector, axpy", t);
+            Bench::run(name, [&] {
+                dwim(par_unseq.with(t), v.begin(), v.end(), axpy);
+                Bench::clobberMemory();
+            }, count);
+
+            std::snprintf(name, sizeof(name), "item05/dwim par_unseq x%u, vector, sqrt+exp", t);
+            Bench::run(name, [&] {
+                dwim(par_unseq.with(t), v.begin(), v.end(), heavy);
+                Bench::clobberMemory();
+            }, count);
+
+            std::snprintf(name, sizeof(name), "item05/dwim par x%u, deque, axpy", t);
+            Bench::run(name, [&] {
+                dwim(par.with(t), d.begin(), d.end(), axpy);
+                Bench::clobberMemory();
+            }, count);
+        }
+    }
+
+    // 五、test2的工作负载：unordered_map<std::string, int> 与 flat_hash_map
+    template<typename Map>
+    void hashMapWorkload(const char* label, const std::vector<std::string>& keys, const std::vector<std::string>& missing)
+    {
+        const std::size_t count = keys.size();
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "item05/%s insert", label);
+        Bench::run(name, [&] {
+            Map m;
+            for (std::size_t i = 0; i < count; ++i) m.emplace(keys[i], static_cast<int>(i));
+            Bench::doNotOptimize(m);
+        }, count);
+
+        Map m;
+        for (std::size_t i = 0; i < count; ++i) m.emplace(keys[i], static_cast<int>(i));
+
+        // 调用方手里只有string_view（例如从报文中切出来的字段）
+        std::vector<std::string_view> hits(keys.begin(), keys.end());
+        std::vector<std::string_view> misses(missing.begin(), missing.end());
+        std::shuffle(hits.begin(), hits.end(), std::mt19937(7));
+
+        auto lookup = [&m](std::string_view key) {
+            if constexpr (requires { m.find(key); }) return m.find(key) != m.end();
+            else return m.find(std::string(key)) != m.end();        // 先构造临时std::string
+        };
+
+        std::snprintf(name, sizeof(name), "item05/%s lookup hit", label);
+        Bench::run(name, [&] {
+            std::size_t found = 0;
+            for (std::string_view key : hits) found += lookup(key);
+            Bench::doNotOptimize(found);
+        }, count);
+
+        std::snprintf(name, sizeof(name), "item05/%s lookup miss", label);
+        Bench::run(name, [&] {
+            std::size_t found = 0;
+            for (std::string_view key : misses) found += lookup(key);
+            Bench::doNotOptimize(found);
+        }, count);
+
+        std::snprintf(name, sizeof(name), "item05/%s iterate", label);
+        Bench::run(name, [&] {
+            long long sum = 0;
+            for (const auto& p : m) sum += p.second;
+            Bench::doNotOptimize(sum);
+        }, count);
+    }
+
+    void hashMaps()
+    {
+        constexpr std::size_t count = 100000;
+
+        std::vector<std::string> keys, missing;
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.push_back("widget-key-with-a-long-name-" + std::to_string(i));
+            missing.push_back("widget-key-not-in-the-map-" + std::to_string(i));
+        }
+
+        hashMapWorkload<std::unordered_map<std::string, int>>("unordered_map", keys, missing);
+        hashMapWorkload<Item05_FlatHashMap::flat_hash_map<std::string, int>>("flat_hash_map", keys, missing);
+    }
+}
+
+void benchItem05()
+{
+    Bench::section("item05 - auto vs explicit types");
+    pairCopy();
+    functionVsAuto();
+
+    Bench::section("item05 - sorting unique_ptr<Widget> (per element)");
+    sortWidgets();
+
+    Bench::section("item05 - dwim scaling (16M floats, per element)");
+    dwimScaling();
+
+    Bench::section("item05 - hash maps, 100K long string keys (per element)");
+    hashMaps();
+}
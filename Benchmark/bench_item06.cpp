@@ -0,0 +1,418 @@
+// 条款6 - auto推导若非己愿，使用显式类型初始化惯用法（Chapter02/item06.cpp、item06_dynamic_bitset.hpp、item06_matrix.hpp、item06_matmul.hpp、item06_feature_cache.hpp、item06_roaring.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter02/item06_dynamic_bitset.hpp"
+#include "Chapter02/item06_feature_cache.hpp"
+#include "Chapter02/item06_matmul.hpp"
+#include "Chapter02/item06_matrix.hpp"
+#include "Chapter02/item06_roaring.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class Widget
+    {
+    };
+
+    std::vector<bool> features(const Widget&)
+    {
+        return std::vector<bool>{ true, false, true, false, true, false, true, false };
+    }
+
+    // 对照组：不经过代理类，也不堆分配
+    std::array<bool, 8> featuresArray(const Widget&)
+    {
+        return { true, false, true, false, true, false, true, false };
+    }
+
+    // 一、features(w)[5] 每次调用都新建一个vector<bool>，再经过reference代理取出bool
+    void featureFlag()
+    {
+        Widget w;
+
+        Bench::run("item06/static_cast<bool>(features(w)[5])", [&] {
+            bool highPriority = static_cast<bool>(features(w)[5]);
+            Bench::doNotOptimize(highPriority);
+        });
+
+        Bench::run("item06/featuresArray(w)[5]", [&] {
+            bool highPriority = featuresArray(w)[5];
+            Bench::doNotOptimize(highPriority);
+        });
+    }
+
+    // 二、vector<bool>的打包存储：省内存，但每次访问都要移位和掩码
+    void proxyAccess()
+    {
+        constexpr std::size_t count = 4096;
+
+        std::vector<bool> packed(count);
+        std::vector<char> plain(count);
+        for (std::size_t i = 0; i < count; i += 3) {
+            packed[i] = true;
+            plain[i] = 1;
+        }
+
+        Bench::run("item06/count vector<bool> via reference", [&] {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < count; ++i) n += packed[i] ? 1 : 0;
+            Bench::doNotOptimize(n);
+        }, count);
+
+        Bench::run("item06/count vector<char>", [&] {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < count; ++i) n += plain[i] ? 1 : 0;
+            Bench::doNotOptimize(n);
+        }, count);
+    }
+
+    // 三、dynamic_bitset：单个Widget的特征，以及整批Widget上的特征掩码运算
+    void dynamicBitset()
+    {
+        using namespace Item06_DynamicBitset;
+        using Example::Widget;
+
+        Widget w;
+
+        // 仍然每次分配，且是按64字节对齐的分配（aligned_alloc），比vector<bool>更慢；热循环中应使用features_into
+        Bench::run("item06/features(w)[5] (dynamic_bitset)", [&] {
+            auto highPriority = Example::features(w)[5];            // bool
+            Bench::doNotOptimize(highPriority);
+        });
+
+        dynamic_bitset bits;
+        Bench::run("item06/features_into(w, bits); bits[5]", [&] {
+            Example::features_into(w, bits);
+            auto highPriority = bits[5];
+            Bench::doNotOptimize(highPriority);
+        });
+
+        // 一批4M个Widget：统计"活跃且未归档"的个数
+        constexpr std::size_t count = 4 * 1024 * 1024;
+
+        std::mt19937 rng(6);
+        std::vector<Widget> batch;
+        batch.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) batch.emplace_back(static_cast<std::uint8_t>(rng()));
+
+        std::vector<bool> activeBools(count), archivedBools(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            activeBools[i] = batch[i].hasFeature(0);
+            archivedBools[i] = batch[i].hasFeature(1);
+        }
+
+        dynamic_bitset active, archived;
+        Example::feature_column_into(batch, 0, active);
+        Example::feature_column_into(batch, 1, archived);
+
+        Bench::run("item06/vector<bool> a && !b, count", [&] {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < count; ++i) n += activeBools[i] && !archivedBools[i];
+            Bench::doNotOptimize(n);
+        }, count / 64);
+
+        dynamic_bitset result;
+        Bench::run("item06/dynamic_bitset andnot + count", [&] {
+            result = active;
+            result.andnot(archived);
+            Bench::doNotOptimize(result.count());
+        }, count / 64);
+
+        Bench::run("item06/dynamic_bitset count", [&] {
+            Bench::doNotOptimize(active.count());
+        }, count / 64);
+
+        // 稀疏集合的遍历：约1/64的位被置位
+        dynamic_bitset sparse(count);
+        std::vector<bool> sparseBools(count);
+        for (std::size_t i = 0; i < count; i += 61) {
+            sparse.set(i);
+            sparseBools[i] = true;
+        }
+
+        Bench::run("item06/vector<bool> scan sparse", [&] {
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (sparseBools[i]) sum += i;
+            }
+            Bench::doNotOptimize(sum);
+        }, count / 64);
+
+        Bench::run("item06/dynamic_bitset find_next sparse", [&] {
+            std::size_t sum = 0;
+            for (auto i = sparse.find_first(); i != dynamic_bitset::npos; i = sparse.find_next(i)) sum += i;
+            Bench::doNotOptimize(sum);
+        }, count / 64);
+    }
+
+    // 四、Matrix sum = m1 + m2 + m3 + m4：每个operator+返回Matrix vs 表达式模板
+    using Item06_Matrix::Matrix;
+
+    Matrix eagerAdd(const Matrix& a, const Matrix& b)
+    {
+        Matrix result(a.rows(), a.cols());
+        for (std::size_t i = 0; i < result.size(); ++i) result[i] = a[i] + b[i];
+        return result;
+    }
+
+    void matrixSum(std::size_t n)
+    {
+        const std::size_t count = n * n;
+        Matrix m1(n, n, 1.0), m2(n, n, 2.0), m3(n, n, 3.0), m4(n, n, 4.0);
+        Matrix sum(n, n);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "item06/%zux%zu eager, temporary per +", n, n);
+        Bench::run(name, [&] {
+            Matrix result = eagerAdd(eagerAdd(eagerAdd(m1, m2), m3), m4);
+            Bench::doNotOptimize(result.data());
+        }, count);
+
+        std::snprintf(name, sizeof(name), "item06/%zux%zu Matrix sum = m1+m2+m3+m4", n, n);
+        Bench::run(name, [&] {
+            Matrix result = m1 + m2 + m3 + m4;
+            Bench::doNotOptimize(result.data());
+        }, count);
+
+        std::snprintf(name, sizeof(name), "item06/%zux%zu sum = m1+m2+m3+m4 (no alloc)", n, n);
+        Bench::run(name, [&] {
+            sum = m1 + m2 + m3 + m4;
+            Bench::doNotOptimize(sum.data());
+        }, count);
+
+        // 下限：手写的融合循环
+        std::snprintf(name, sizeof(name), "item06/%zux%zu hand-written fused loop", n, n);
+        Bench::run(name, [&] {
+            double* out = sum.data();
+            for (std::size_t i = 0; i < count; ++i) out[i] = m1[i] + m2[i] + m3[i] + m4[i];
+            Bench::doNotOptimize(sum.data());
+        }, count);
+    }
+
+    // 五、矩阵乘法：朴素三重循环 vs 分块、打包、微内核、多线程
+    Matrix naiveMultiply(const Matrix& a, const Matrix& b)
+    {
+        const std::size_t m = a.rows(), n = b.cols(), k = a.cols();
+        Matrix c(m, n);
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                double sum = 0;
+                for (std::size_t p = 0; p < k; ++p) sum += a(i, p) * b(p, j);
+                c(i, j) = sum;
+            }
+        }
+        return c;
+    }
+
+    // ns/op为一次乘法的耗时，下一行换算成GFLOP/s（一次乘法 2 * n^3 次浮点运算）
+    template<typename F>
+    void runGflops(const char* name, std::size_t n, F&& body)
+    {
+        const auto result = Bench::run(name, body);
+        std::printf("%-48s %12.2f GFLOP/s\n", "", 2.0 * double(n) * double(n) * double(n) / result.nsPerOp);
+    }
+
+    void matrixMultiply()
+    {
+        char name[64];
+        const unsigned cores = static_cast<unsigned>(Item05_Dwim::ThreadPool::instance().size());
+        std::vector<unsigned> threadCounts;
+        for (unsigned t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(cores);
+
+        // 4096^2一次乘法约137 GFLOP，在单核上要跑数秒；预热加一次测量即可得到稳定的结果
+        for (std::size_t n : { 256, 512, 1024, 2048, 4096 }) {
+            std::mt19937 rng(static_cast<unsigned>(n));
+            std::uniform_real_distribution<double> dist(-1.0, 1.0);
+            Matrix a(n, n), b(n, n), c;
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                a[i] = dist(rng);
+                b[i] = dist(rng);
+            }
+
+            // 朴素版本在1024以上一次要跑数秒，只测小尺寸
+            if (n <= 512) {
+                std::snprintf(name, sizeof(name), "item06/%zu^2 naive triple loop", n);
+                runGflops(name, n, [&] {
+                    Matrix result = naiveMultiply(a, b);
+                    Bench::doNotOptimize(result.data());
+                });
+            }
+
+            for (unsigned t : threadCounts) {
+                std::snprintf(name, sizeof(name), "item06/%zu^2 multiply x%u", n, t);
+                runGflops(name, n, [&] {
+                    Item06_MatMul::multiply(a, b, c, t);
+                    Bench::doNotOptimize(c.data());
+                });
+            }
+        }
+    }
+
+    // 六、features(w)[5]：每次重新计算 vs 按Widget缓存
+    void featureCache()
+    {
+        using namespace Item06_FeatureCache;
+        using Example::Widget;
+
+        constexpr std::size_t count = 10000;
+        std::vector<Widget> widgets;
+        widgets.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) widgets.emplace_back(static_cast<int>(i * 2654435761u));
+
+        Bench::run("item06/features(w)[5], recomputed", [&] {
+            std::size_t n = 0;
+            for (const Widget& w : widgets) n += static_cast<bool>(Example::features(w)[5]);
+            Bench::doNotOptimize(n);
+        }, count);
+
+        auto cache = makeFeatureCache<Widget>([](const Widget& w) { return Example::features(w); });
+
+        Bench::run("item06/cache.flag(w, 5), hit", [&] {
+            std::size_t n = 0;
+            for (const Widget& w : widgets) n += cache.flag(w, 5);
+            Bench::doNotOptimize(n);
+        }, count);
+
+        // 每次访问前都修改Widget：全部因版本过期而重新计算
+        Bench::run("item06/cache.flag(w, 5), stale after touch()", [&] {
+            std::size_t n = 0;
+            for (Widget& w : widgets) {
+                w.touch();
+                n += cache.flag(w, 5);
+            }
+            Bench::doNotOptimize(n);
+        }, count);
+
+        // 多个线程同时读：各线程从不同位置开始，分散到各分片
+        const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+        char name[64];
+        std::snprintf(name, sizeof(name), "item06/cache.flag(w, 5), hit, %u threads", threads);
+        Bench::run(name, [&] {
+            std::vector<std::thread> readers;
+            for (unsigned t = 0; t < threads; ++t) {
+                readers.emplace_back([&, t] {
+                    std::size_t n = 0;
+                    for (std::size_t i = 0; i < count; ++i) n += cache.flag(widgets[(i + t * 997) % count], 5);
+                    Bench::doNotOptimize(n);
+                });
+            }
+            for (auto& r : readers) r.join();
+        }, count * threads);
+
+        const Stats stats = cache.stats();
+        std::printf("  cache: hits %llu, misses %llu (stale %llu), flushes %llu, entries %zu, hit rate %.3f\n",
+                    static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+                    static_cast<unsigned long long>(stats.stale), static_cast<unsigned long long>(stats.flushes),
+                    stats.entries, stats.hitRate());
+    }
+
+    // 七、1000万个Widget上的按列查询：Roaring位图 vs 未压缩的dynamic_bitset
+    void bitmapIndex()
+    {
+        using namespace Item06_Roaring;
+        using Example::Widget;
+
+        constexpr std::size_t count = 10'000'000;
+
+        // 特征0：50%随机（稠密）；特征1：0.05%随机（稀疏）；特征2：每20万个中连续5万个（成段）；特征5：20%随机
+        std::mt19937_64 rng(19);
+        std::vector<Widget> widgets;
+        widgets.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint64_t r = rng();
+            std::uint64_t flags = 0;
+            flags |= (r & 1) << 0;
+            flags |= std::uint64_t((r >> 8) % 2000 == 0) << 1;
+            flags |= std::uint64_t((i / 50000) % 4 == 0) << 2;
+            flags |= std::uint64_t((r >> 24) % 5 == 0) << 5;
+            widgets.emplace_back(flags);
+        }
+
+        Bench::run("item06/roaring build index (10M widgets)", [&] {
+            FeatureIndex index(widgets);
+            Bench::doNotOptimize(index);
+        }, count);
+
+        const FeatureIndex index(widgets);
+        const RoaringBitmap& f0 = index.column(0);
+        const RoaringBitmap& f1 = index.column(1);
+        const RoaringBitmap& f2 = index.column(2);
+        const RoaringBitmap& f5 = index.column(5);
+
+        // 查询的ns/op是一次查询的耗时
+        Bench::run("item06/roaring f5 andnot f2 (materialized)", [&] {
+            RoaringBitmap hits = andnot(f5, f2);
+            Bench::doNotOptimize(hits);
+        });
+
+        Bench::run("item06/roaring andnot_cardinality(f5, f2)", [&] {
+            Bench::doNotOptimize(andnot_cardinality(f5, f2));
+        });
+
+        Bench::run("item06/roaring and_cardinality(dense, sparse)", [&] {
+            Bench::doNotOptimize(and_cardinality(f0, f1));
+        });
+
+        Bench::run("item06/roaring or_cardinality(f0, f5)", [&] {
+            Bench::doNotOptimize(or_cardinality(f0, f5));
+        });
+
+        using Item06_DynamicBitset::dynamic_bitset;
+        auto column = [&](std::size_t k) {
+            dynamic_bitset bits(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (widgets[i].hasFeature(k)) bits.set(i);
+            }
+            return bits;
+        };
+        const dynamic_bitset b0 = column(0), b1 = column(1), b2 = column(2), b5 = column(5);
+        dynamic_bitset result;
+
+        Bench::run("item06/dynamic_bitset f5 andnot f2, count", [&] {
+            result = b5;
+            result.andnot(b2);
+            Bench::doNotOptimize(result.count());
+        });
+
+        Bench::run("item06/dynamic_bitset (dense & sparse), count", [&] {
+            result = b0;
+            result &= b1;
+            Bench::doNotOptimize(result.count());
+        });
+
+        std::printf("  column bytes: roaring f0 %zu, f1 %zu, f2 %zu, f5 %zu; dynamic_bitset %zu each\n",
+                    f0.size_in_bytes(), f1.size_in_bytes(), f2.size_in_bytes(), f5.size_in_bytes(),
+                    b0.word_count() * sizeof(dynamic_bitset::word_type));
+    }
+}
+
+void benchItem06()
+{
+    Bench::section("item06 - proxy classes");
+    featureFlag();
+    proxyAccess();
+
+    Bench::section("item06 - dynamic_bitset (4M-widget rows: per 64 widgets)");
+    dynamicBitset();
+
+    Bench::section("item06 - expression templates (per element)");
+    matrixSum(64);
+    matrixSum(1024);
+
+    Bench::section("item06 - matrix multiply (ns per multiply)");
+    matrixMultiply();
+
+    Bench::section("item06 - feature cache, 10K widgets (per lookup)");
+    featureCache();
+
+    Bench::section("item06 - bitmap index, 10M widgets (build: per widget, queries: per query)");
+    bitmapIndex();
+}
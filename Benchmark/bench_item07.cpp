@@ -0,0 +1,189 @@
+// 条款7 - 区别使用()和{}创建对象（Chapter03/item07.cpp、Chapter03/item07_arena.hpp、Chapter03/item07_object_pool.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter03/item07_arena.hpp"
+#include "Chapter03/item07_object_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // 与item07.cpp中的doSomeWork相同，但分别给出圆括号和花括号两个版本
+    template <typename T, typename... Args>
+    T* doSomeWorkParen(Args&&... args)
+    {
+        return new T(std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename... Args>
+    T* doSomeWorkBrace(Args&&... args)
+    {
+        return new T{ std::forward<Args>(args)... };
+    }
+
+    // 一、vector(10, 20) 与 vector{10, 20} 不只是语义不同，分配的大小也不同
+    void vectorCtor()
+    {
+        Bench::run("item07/std::vector<int> v1(10, 20)", [] {
+            std::vector<int> v1(10, 20);
+            Bench::doNotOptimize(v1.data());
+        });
+
+        Bench::run("item07/std::vector<int> v2{10, 20}", [] {
+            std::vector<int> v2{ 10, 20 };
+            Bench::doNotOptimize(v2.data());
+        });
+    }
+
+    // 二、doSomeWork<std::vector<int>>(10, 20) 的结果取决于作者选择的括号
+    void doSomeWork()
+    {
+        Bench::run("item07/doSomeWork paren (10 elements)", [] {
+            auto p = doSomeWorkParen<std::vector<int>>(10, 20);
+            Bench::doNotOptimize(p);
+            delete p;
+        });
+
+        Bench::run("item07/doSomeWork brace (2 elements)", [] {
+            auto p = doSomeWorkBrace<std::vector<int>>(10, 20);
+            Bench::doNotOptimize(p);
+            delete p;
+        });
+    }
+
+    // 三、一个请求内的对象图：逐个new/delete vs arena.make + reset()
+    struct Node
+    {
+        int id;
+        double weight;
+        Node* next;
+    };
+
+    struct Field
+    {
+        std::string name;
+        std::string value;
+    };
+
+    constexpr int NodesPerRequest = 256;
+    constexpr int FieldsPerRequest = 32;
+
+    // 平凡析构：reset()是O(1)
+    void nodeGraph()
+    {
+        Bench::run("item07/graph of 256 nodes: new/delete", [] {
+            Node* nodes[NodesPerRequest];
+            Node* prev = nullptr;
+            for (int i = 0; i < NodesPerRequest; ++i) prev = nodes[i] = doSomeWorkBrace<Node>(i, 0.5 * i, prev);
+            Bench::doNotOptimize(prev);
+            for (Node* n : nodes) delete n;
+        }, NodesPerRequest);
+
+        Item07_Arena::Arena arena;
+        Bench::run("item07/graph of 256 nodes: arena + reset", [&] {
+            Node* prev = nullptr;
+            for (int i = 0; i < NodesPerRequest; ++i) prev = arena.make<Node, Item07_Arena::Init::Brace>(i, 0.5 * i, prev);
+            Bench::doNotOptimize(prev);
+            arena.reset();
+        }, NodesPerRequest);
+    }
+
+    // 非平凡析构：reset()逆序调用析构函数，省下的是分配和释放
+    void fieldGraph()
+    {
+        Bench::run("item07/request of 32 fields: new/delete", [] {
+            auto* fields = doSomeWorkParen<std::vector<Field*>>();
+            fields->reserve(FieldsPerRequest);
+            for (int i = 0; i < FieldsPerRequest; ++i) fields->push_back(doSomeWorkBrace<Field>("X-Header", "value"));
+            Bench::doNotOptimize(fields->data());
+            for (Field* f : *fields) delete f;
+            delete fields;
+        }, FieldsPerRequest);
+
+        using Fields = std::vector<Field*, Item07_Arena::Allocator<Field*>>;
+
+        Item07_Arena::Arena arena;
+        Bench::run("item07/request of 32 fields: arena + reset", [&] {
+            auto* fields = arena.make<Fields>(arena.allocator<Field*>());
+            fields->reserve(FieldsPerRequest);
+            for (int i = 0; i < FieldsPerRequest; ++i) fields->push_back(arena.make<Field, Item07_Arena::Init::Brace>("X-Header", "value"));
+            Bench::doNotOptimize(fields->data());
+            arena.reset();
+        }, FieldsPerRequest);
+
+        std::printf("  arena: %zu bytes reserved after warm-up\n", arena.bytesReserved());
+    }
+
+    // 四、一个一个死去的对象：每个线程保持64个存活对象，每次销毁最老的一个、再创建一个
+    struct Message
+    {
+        int id;
+        int kind;
+        double payload[6] = {};
+    };
+
+    constexpr std::size_t Window = 64;
+    constexpr std::size_t OpsPerThread = 100000;
+
+    template<typename Make>
+    void churn(Make make)
+    {
+        using Ptr = decltype(make(0));
+        Ptr window[Window];
+        for (std::size_t i = 0; i < Window; ++i) window[i] = make(static_cast<int>(i));
+        for (std::size_t i = 0; i < OpsPerThread; ++i) {
+            window[i % Window] = make(static_cast<int>(i));        // 旧对象在赋值时销毁
+            Bench::doNotOptimize(window[i % Window]);
+        }
+    }
+
+    template<typename Make>
+    void churnThreads(const char* label, unsigned threads, Make make)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "item07/churn %s, %u threads", label, threads);
+        Bench::run(name, [&] {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) workers.emplace_back([&] { churn(make); });
+            for (auto& w : workers) w.join();
+        }, OpsPerThread * threads);
+    }
+
+    void objectPool()
+    {
+        using Item07_ObjectPool::object_pool;
+        using Item07_ObjectPool::Init;
+
+        const unsigned cores = std::max(4u, std::thread::hardware_concurrency());
+        std::vector<unsigned> threadCounts;
+        for (unsigned t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(cores);
+
+        object_pool<Message> pool;
+        for (unsigned t : threadCounts) {
+            churnThreads("new/delete", t, [](int i) { return std::unique_ptr<Message>(new Message{ i, 0, {} }); });
+            churnThreads("object_pool", t, [&](int i) { return pool.make<Init::Brace>(i, 0); });
+        }
+
+        const Item07_ObjectPool::Stats stats = pool.stats();
+        std::printf("  pool: live %lld, peak %lld, capacity %zu, depot %zu\n", static_cast<long long>(stats.live),
+                    static_cast<long long>(stats.peak), stats.capacity, stats.depot);
+    }
+}
+
+void benchItem07()
+{
+    Bench::section("item07 - () vs {}");
+    vectorCtor();
+    doSomeWork();
+    nodeGraph();
+    fieldGraph();
+    objectPool();
+}
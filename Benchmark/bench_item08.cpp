@@ -0,0 +1,323 @@
+// 条款8 - 优先考虑nullptr而非0和NULL（Chapter03/item08.cpp、Chapter03/item08_flat_combining.hpp、Chapter03/item08_profiled_mutex.hpp、
+//        Chapter03/item08_snapshot.hpp、Chapter03/item08_adaptive_mutex.hpp）
+
+#include "bench.hpp"
+
+#include "Chapter03/item08_adaptive_mutex.hpp"
+#include "Chapter03/item08_flat_combining.hpp"
+#include "Chapter03/item08_profiled_mutex.hpp"
+#include "Chapter03/item08_snapshot.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class Widget
+    {
+    };
+
+    bool f3(Widget* pw)
+    {
+        Bench::doNotOptimize(pw);
+        return pw == nullptr;
+    }
+
+    template <typename Func, typename Mutex, typename Ptr>
+    auto callWithLock(Func f, Mutex& mtx, Ptr pw) -> decltype(f(pw))
+    {
+        std::lock_guard<Mutex> g(mtx);
+        return f(pw);
+    }
+
+    // callWithLock的模板化本身没有代价（nullptr推导为std::nullptr_t再转换为Widget*），
+    // 代价全部来自无竞争时的加锁/解锁
+    void callCost()
+    {
+        std::mutex mtx;
+
+        Bench::run("item08/f3(nullptr) direct", [&] {
+            auto result = f3(nullptr);
+            Bench::doNotOptimize(result);
+        });
+
+        Bench::run("item08/callWithLock(f3, mtx, nullptr)", [&] {
+            auto result = callWithLock(f3, mtx, nullptr);
+            Bench::doNotOptimize(result);
+        });
+    }
+
+    // 二、高竞争：所有线程对同一把锁调用f，f读写一小块共享状态
+    struct Shared
+    {
+        long counters[8] = {};      // 一个缓存行：在各核之间来回传递的就是它
+    };
+
+    constexpr std::size_t CallsPerThread = 20000;
+
+    template<typename Mutex>
+    void contended(const char* label, unsigned threads)
+    {
+        Shared shared;
+        Mutex mtx;
+        auto f = [&shared](Widget* pw) {
+            for (long& c : shared.counters) ++c;
+            return pw == nullptr;
+        };
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "item08/%s, %u threads", label, threads);
+        Bench::run(name, [&] {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    bool all = true;
+                    for (std::size_t i = 0; i < CallsPerThread; ++i) {
+                        if constexpr (std::is_same_v<Mutex, Item08_FlatCombining::FlatCombiner>) {
+                            all &= Item08_FlatCombining::callWithLock(f, mtx, nullptr);
+                        }
+                        else {
+                            all &= callWithLock(f, mtx, nullptr);
+                        }
+                    }
+                    Bench::doNotOptimize(all);
+                });
+            }
+            for (auto& w : workers) w.join();
+        }, CallsPerThread * threads);
+
+        if constexpr (std::is_same_v<Mutex, Item08_FlatCombining::FlatCombiner>) {
+            const double batch = mtx.combinedBatches() == 0 ? 0.0
+                : static_cast<double>(mtx.combinedRequests()) / static_cast<double>(mtx.combinedBatches());
+            std::printf("  flat combining: %.2f calls per batch\n", batch);
+        }
+    }
+
+    void contention()
+    {
+        for (unsigned threads = 1; threads <= 64; threads *= 2) {
+            contended<std::mutex>("std::mutex", threads);
+            contended<Item08_FlatCombining::FlatCombiner>("flat combining", threads);
+        }
+    }
+
+    // 三、profiled_mutex：关闭时的代价，以及f1m/f2m/f3m的报告
+    void profiling()
+    {
+        using Item08_ProfiledMutex::profiled_mutex;
+
+        std::mutex plain;
+        profiled_mutex<std::mutex> f3m("f3m");
+
+        Bench::run("item08/callWithLock, std::mutex", [&] {
+            auto result = callWithLock(f3, plain, nullptr);
+            Bench::doNotOptimize(result);
+        });
+
+        Item08_ProfiledMutex::setEnabled(false);
+        Bench::run("item08/callWithLock, profiled_mutex (off)", [&] {
+            auto result = callWithLock(f3, f3m, nullptr);
+            Bench::doNotOptimize(result);
+        });
+
+        Item08_ProfiledMutex::setEnabled(true);
+        Bench::run("item08/callWithLock, profiled_mutex (on)", [&] {
+            auto result = callWithLock(f3, f3m, nullptr);
+            Bench::doNotOptimize(result);
+        });
+
+        // 三把锁负载不同：f1m临界区长，f2m调用频繁，f3m很少使用
+        profiled_mutex<std::mutex> f1m("f1m"), f2m("f2m");
+        Item08_ProfiledMutex::resetCounters();
+
+        Shared shared;
+        auto work = [&shared](int rounds) {
+            return [&shared, rounds](Widget* pw) {
+                for (int r = 0; r < rounds; ++r) {
+                    for (long& c : shared.counters) ++c;
+                    Bench::clobberMemory();
+                }
+                return pw == nullptr;
+            };
+        };
+        auto f1 = work(64), f2 = work(4);
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < 8; ++t) {
+            workers.emplace_back([&] {
+                for (std::size_t i = 0; i < CallsPerThread; ++i) {
+                    callWithLock(f1, f1m, nullptr);
+                    callWithLock(f2, f2m, nullptr);
+                    callWithLock(f2, f2m, nullptr);
+                    if (i % 64 == 0) callWithLock(f3, f3m, nullptr);
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        Item08_ProfiledMutex::setEnabled(false);
+
+        std::fflush(stdout);
+        Item08_ProfiledMutex::report(std::cout);
+        std::cout.flush();
+    }
+
+    // 四、读多写少：f读取Widget的状态，偶尔修改
+    struct WidgetState
+    {
+        long fields[8] = {};
+    };
+
+    constexpr std::size_t OpsPerReader = 50000;
+
+    long readState(const WidgetState& w)
+    {
+        long sum = 0;
+        for (long f : w.fields) sum += f;
+        return sum;
+    }
+
+    void writeState(WidgetState& w)
+    {
+        for (long& f : w.fields) ++f;
+    }
+
+    // 第i次操作是否为写：每100次中有writesPer100次
+    bool isWrite(std::size_t i, unsigned writesPer100) { return i % 100 < writesPer100; }
+
+    template<typename Op>
+    void readMostly(const char* label, unsigned threads, unsigned writesPer100, Op op)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "item08/%u:%u %s, %u threads", 100 - writesPer100, writesPer100, label, threads);
+        Bench::run(name, [&] {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    long sum = 0;
+                    for (std::size_t i = 0; i < OpsPerReader; ++i) sum += op(isWrite(i + t * 37, writesPer100));
+                    Bench::doNotOptimize(sum);
+                });
+            }
+            for (auto& w : workers) w.join();
+        }, OpsPerReader * threads);
+    }
+
+    void snapshots()
+    {
+        using Item08_Snapshot::Snapshot;
+        using Item08_Snapshot::callWithSnapshot;
+
+        const unsigned cores = std::max(4u, std::thread::hardware_concurrency());
+
+        for (unsigned writesPer100 : { 1u, 10u }) {
+            for (unsigned threads = 1; threads <= cores; threads *= 2) {
+                WidgetState plain;
+                std::mutex mtx;
+                readMostly("std::mutex", threads, writesPer100, [&](bool write) {
+                    std::lock_guard g(mtx);
+                    if (write) writeState(plain);
+                    return readState(plain);
+                });
+
+                std::shared_mutex smtx;
+                readMostly("std::shared_mutex", threads, writesPer100, [&](bool write) {
+                    if (write) {
+                        std::unique_lock g(smtx);
+                        writeState(plain);
+                        return readState(plain);
+                    }
+                    std::shared_lock g(smtx);
+                    return readState(plain);
+                });
+
+                Snapshot<WidgetState> widget;
+                readMostly("callWithSnapshot", threads, writesPer100, [&](bool write) {
+                    if (write) widget.update(writeState);
+                    return callWithSnapshot(readState, widget);
+                });
+            }
+        }
+    }
+
+    // 五、短临界区的加锁延迟分布：每次 加锁 + 临界区 + 解锁 的耗时
+    constexpr std::size_t SamplesPerThread = 20000;
+
+    template<typename Mutex>
+    void latency(const char* label, unsigned threads)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Shared shared;
+        Mutex mtx;
+        std::vector<std::vector<std::uint64_t>> samples(threads);
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                auto& out = samples[t];
+                out.reserve(SamplesPerThread);
+                for (std::size_t i = 0; i < SamplesPerThread; ++i) {
+                    const auto start = Clock::now();
+                    {
+                        std::lock_guard g(mtx);
+                        for (long& c : shared.counters) ++c;
+                    }
+                    const auto end = Clock::now();
+                    out.push_back(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+                    // 临界区之外的一点工作，让线程不总是在抢锁
+                    for (int k = 0; k < 16; ++k) Bench::clobberMemory();
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+
+        std::vector<std::uint64_t> all;
+        for (auto& v : samples) all.insert(all.end(), v.begin(), v.end());
+        std::sort(all.begin(), all.end());
+        auto at = [&](double p) { return static_cast<unsigned long long>(all[static_cast<std::size_t>(p * static_cast<double>(all.size() - 1))]); };
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "item08/latency %s, %u threads", label, threads);
+        std::printf("%-48s p50 %6llu ns  p99 %8llu ns  p999 %9llu ns\n", name, at(0.50), at(0.99), at(0.999));
+    }
+
+    void adaptive()
+    {
+        using Item08_AdaptiveMutex::adaptive_mutex;
+
+        std::mutex plain;
+        adaptive_mutex f3m;
+        Bench::run("item08/callWithLock, std::mutex (uncontended)", [&] {
+            auto result = callWithLock(f3, plain, nullptr);
+            Bench::doNotOptimize(result);
+        });
+        Bench::run("item08/callWithLock, adaptive_mutex", [&] {
+            auto result = callWithLock(f3, f3m, nullptr);
+            Bench::doNotOptimize(result);
+        });
+
+        const unsigned cores = std::max(4u, std::thread::hardware_concurrency());
+        for (unsigned threads = 1; threads <= cores; threads *= 2) {
+            latency<std::mutex>("std::mutex", threads);
+            latency<adaptive_mutex>("adaptive_mutex", threads);
+        }
+    }
+}
+
+void benchItem08()
+{
+    Bench::section("item08 - callWithLock");
+    callCost();
+    contention();
+    profiling();
+    snapshots();
+    adaptive();
+}
@@ -0,0 +1,47 @@
+// 条款10 - 优先考虑限域enum而非未限域enum（Chapter03/item10.cpp）
+
+#include "bench.hpp"
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace
+{
+    using UserInfo =
+        std::tuple<std::string,     //名字
+                   std::string,     //email地址
+                   std::size_t>;    //声望
+
+    enum class UserInfoFields { uiName, uiEmail, uiReputation };
+
+    template<typename EnumType>
+    constexpr auto toUType(EnumType e) noexcept
+    {
+        return static_cast<std::underlying_type_t<EnumType>>(e);
+    }
+
+    // toUType在编译期求值，std::get<toUType(...)>与std::get<2>应生成相同的代码
+    void toUTypeCost()
+    {
+        UserInfo uInfo{ "name", "email", 42 };
+
+        Bench::run("item10/std::get<2>(uInfo)", [&] {
+            Bench::clobberMemory();
+            auto val = std::get<2>(uInfo);
+            Bench::doNotOptimize(val);
+        });
+
+        Bench::run("item10/std::get<toUType(uiReputation)>(uInfo)", [&] {
+            Bench::clobberMemory();
+            auto val = std::get<toUType(UserInfoFields::uiReputation)>(uInfo);
+            Bench::doNotOptimize(val);
+        });
+    }
+}
+
+void benchItem10()
+{
+    Bench::section("item10 - scoped enum");
+    toUTypeCost();
+}
@@ -0,0 +1,60 @@
+// 条款12 - 使用override声明重写函数（Chapter03/item12.cpp 四、成员函数引用限定）
+
+#include "bench.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t valueCount = 1000;
+
+    // 只有左值引用版本的data()
+    class Widget
+    {
+    public:
+        using DataType = std::vector<double>;
+
+        Widget() : values(valueCount, 1.0) {}
+
+        DataType& data() { return values; }
+
+    private:
+        DataType values;
+    };
+
+    // 加入右值引用限定的data()
+    class RefQualifiedWidget
+    {
+    public:
+        using DataType = std::vector<double>;
+
+        RefQualifiedWidget() : values(valueCount, 1.0) {}
+
+        DataType& data() & { return values; }
+        DataType data() && { return std::move(values); }
+
+    private:
+        DataType values;
+    };
+
+    // makeWidget().data() 对临时对象取数据：拷贝 vs 移动
+    void dataFromTemporary()
+    {
+        Bench::run("item12/makeWidget().data() copy", [] {
+            auto vals = Widget().data();
+            Bench::doNotOptimize(vals.data());
+        });
+
+        Bench::run("item12/makeWidget().data() && move", [] {
+            auto vals = RefQualifiedWidget().data();
+            Bench::doNotOptimize(vals.data());
+        });
+    }
+}
+
+void benchItem12()
+{
+    Bench::section("item12 - reference qualifiers");
+    dataFromTemporary();
+}
@@ -0,0 +1,41 @@
+// 条款13 - 优先考虑const_iterator而非iterator（Chapter03/item13.cpp）
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    // const_iterator只是类型层面的约束，运行时代价应与iterator一致
+    void findAndInsert()
+    {
+        constexpr int count = 1000;
+
+        std::vector<int> base(count);
+        for (int i = 0; i < count; ++i) base[i] = i;
+        std::vector<int> values;
+        values.reserve(count + 1);
+
+        Bench::run("item13/find+insert via iterator", [&] {
+            values.assign(base.begin(), base.end());
+            auto it = std::find(values.begin(), values.end(), count / 2);
+            values.insert(it, 1998);
+            Bench::doNotOptimize(values.data());
+        });
+
+        Bench::run("item13/find+insert via const_iterator", [&] {
+            values.assign(base.begin(), base.end());
+            auto ci = std::find(std::cbegin(values), std::cend(values), count / 2);
+            values.insert(ci, 1998);
+            Bench::doNotOptimize(values.data());
+        });
+    }
+}
+
+void benchItem13()
+{
+    Bench::section("item13 - const_iterator");
+    findAndInsert();
+}
@@ -0,0 +1,56 @@
+// 条款14 - 如果函数不抛出异常请使用noexcept（Chapter03/item14.cpp 二、STL中的noexcept）
+
+#include "bench.hpp"
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // 移动构造函数未声明noexcept：vector扩容时move_if_noexcept会退回到拷贝
+    struct ThrowingMove
+    {
+        explicit ThrowingMove(const std::string& s) : text(s) {}
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&& rhs) : text(std::move(rhs.text)) {}
+
+        std::string text;
+    };
+
+    // 移动构造函数声明noexcept：vector扩容时直接移动
+    struct NoexceptMove
+    {
+        explicit NoexceptMove(const std::string& s) : text(s) {}
+        NoexceptMove(const NoexceptMove&) = default;
+        NoexceptMove(NoexceptMove&& rhs) noexcept : text(std::move(rhs.text)) {}
+
+        std::string text;
+    };
+
+    static_assert(!std::is_nothrow_move_constructible<ThrowingMove>::value, "");
+    static_assert(std::is_nothrow_move_constructible<NoexceptMove>::value, "");
+
+    template<typename T>
+    void pushBack(const char* name)
+    {
+        constexpr std::size_t count = 1000;
+        const std::string text(64, 'x');        // 超出SSO，拷贝一定会堆分配
+
+        Bench::run(name, [&] {
+            std::vector<T> v;                   // 不reserve，让扩容真正发生
+            for (std::size_t i = 0; i < count; ++i) {
+                v.emplace_back(text);
+            }
+            Bench::doNotOptimize(v.data());
+        }, count);
+    }
+}
+
+void benchItem14()
+{
+    Bench::section("item14 - noexcept move and vector reallocation");
+    pushBack<ThrowingMove>("item14/push_back, move ctor not noexcept");
+    pushBack<NoexceptMove>("item14/push_back, move ctor noexcept");
+}
@@ -0,0 +1,36 @@
+// 条款15 - 尽可能的使用constexpr（Chapter03/item15.cpp）
+
+#include "bench.hpp"
+
+namespace
+{
+    constexpr int pow(int base, int exp) noexcept
+    {
+        auto result = 1;
+        for (int i = 0; i < exp; ++i) result *= base;
+        return result;
+    }
+
+    // 实参编译期可知时结果直接写入可执行文件；实参运行时才知道时就是一次普通调用
+    void powCost()
+    {
+        volatile int base = 3;
+        volatile int exp = 5;
+
+        Bench::run("item15/pow(3, 5) constexpr", [] {
+            constexpr auto result = pow(3, 5);
+            Bench::doNotOptimize(result);
+        });
+
+        Bench::run("item15/pow(base, exp) runtime", [&] {
+            auto result = pow(base, exp);
+            Bench::doNotOptimize(result);
+        });
+    }
+}
+
+void benchItem15()
+{
+    Bench::section("item15 - constexpr");
+    powCost();
+}
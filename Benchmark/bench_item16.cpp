@@ -0,0 +1,83 @@
+// 条款16 - 让const成员函数线程安全（Chapter03/item16.cpp）
+
+#include "bench.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+    // 与Item16_02相同：用atomic缓存（单变量时才正确，这里只测开销）
+    class AtomicWidget
+    {
+        int expensiveComputation1() const { return 1; }
+        int expensiveComputation2() const { return 2; }
+
+    public:
+        int magicValue() const
+        {
+            if (cacheValid) return cachedValue;
+            else {
+                auto val1 = expensiveComputation1();
+                auto val2 = expensiveComputation2();
+                cachedValue = val1 + val2;
+                cacheValid = true;
+                return cachedValue;
+            }
+        }
+
+    private:
+        mutable std::atomic<bool> cacheValid{ false };
+        mutable std::atomic<int> cachedValue{ 0 };
+    };
+
+    // 与Item16_03相同：用互斥量保护缓存
+    class MutexWidget
+    {
+        int expensiveComputation1() const { return 1; }
+        int expensiveComputation2() const { return 2; }
+
+    public:
+        int magicValue() const
+        {
+            std::lock_guard<std::mutex> guard(m);
+
+            if (cacheValid) return cachedValue;
+            else {
+                auto val1 = expensiveComputation1();
+                auto val2 = expensiveComputation2();
+                cachedValue = val1 + val2;
+                cacheValid = true;
+                return cachedValue;
+            }
+        }
+
+    private:
+        mutable std::mutex m;
+        mutable int cachedValue{ 0 };
+        mutable bool cacheValid{ false };
+    };
+
+    // 缓存命中后的读取代价
+    void cachedRead()
+    {
+        AtomicWidget aw;
+        MutexWidget mw;
+
+        Bench::run("item16/magicValue atomic cache", [&] {
+            auto v = aw.magicValue();
+            Bench::doNotOptimize(v);
+        });
+
+        Bench::run("item16/magicValue mutex cache", [&] {
+            auto v = mw.magicValue();
+            Bench::doNotOptimize(v);
+        });
+    }
+}
+
+void benchItem16()
+{
+    Bench::section("item16 - atomic vs mutex");
+    cachedRead();
+}
@@ -0,0 +1,142 @@
+// emcp_bench - 逐条款测量Chapter02/Chapter03中的性能结论
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// 一、分配统计
+// 替换全局operator new/delete，统计每次堆分配的次数与字节数。
+// 标准规定new[]和nothrow版本默认转调这里的版本，所以只需替换以下几个。
+
+namespace Bench
+{
+    AllocCounter& allocCounter()
+    {
+        static AllocCounter counter;
+        return counter;
+    }
+}
+
+namespace
+{
+    void* countedAlloc(std::size_t size)
+    {
+        auto& counter = Bench::allocCounter();
+        counter.count.fetch_add(1, std::memory_order_relaxed);
+        counter.bytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* countedAlignedAlloc(std::size_t size, std::size_t alignment)
+    {
+        auto& counter = Bench::allocCounter();
+        counter.count.fetch_add(1, std::memory_order_relaxed);
+        counter.bytes.fetch_add(size, std::memory_order_relaxed);
+#if defined(_WIN32)
+        return _aligned_malloc(size ? size : 1, alignment);
+#else
+        // aligned_alloc要求size是alignment的整数倍
+        auto rounded = (size + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, rounded ? rounded : alignment);
+#endif
+    }
+
+    void alignedFree(void* p)
+    {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    if (auto p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto p = countedAlignedAlloc(size, static_cast<std::size_t>(alignment))) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+
+// 二、报告输出
+
+namespace Bench
+{
+    void section(const char* title)
+    {
+        std::printf("\n== %s ==\n", title);
+        std::printf("%-48s %12s %12s %12s\n", "benchmark", "ns/op", "allocs/op", "bytes/op");
+    }
+
+    void report(const char* name, const Result& result)
+    {
+        std::printf("%-48s %12.2f %12.3f %12.1f\n",
+                    name, result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+        std::fflush(stdout);
+    }
+}
+
+
+// 三、入口
+// 用法：emcp_bench [过滤串...]
+// 不带参数时运行全部条款；带参数时只运行名字中包含任一过滤串的条款，如 emcp_bench item05 item14
+// 条款9、11只涉及编译期行为（别名声明、deleted函数），没有运行时开销可测
+
+namespace
+{
+    struct Entry
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const Entry entries[] = {
+        { "item01", &benchItem01 },
+        { "item02", &benchItem02 },
+        { "item03", &benchItem03 },
+        { "item04", &benchItem04 },
+        { "item05", &benchItem05 },
+        { "item06", &benchItem06 },
+        { "item07", &benchItem07 },
+        { "item08", &benchItem08 },
+        { "item10", &benchItem10 },
+        { "item12", &benchItem12 },
+        { "item13", &benchItem13 },
+        { "item14", &benchItem14 },
+        { "item15", &benchItem15 },
+        { "item16", &benchItem16 },
+    };
+
+    bool selected(const char* name, int argc, char** argv)
+    {
+        if (argc <= 1) return true;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strstr(name, argv[i]) != nullptr) return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    for (const auto& entry : entries) {
+        if (selected(entry.name, argc, argv)) {
+            entry.run();
+        }
+    }
+
+    return 0;
+}
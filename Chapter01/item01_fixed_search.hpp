@@ -0,0 +1,386 @@
+/* 条款1 扩展 - 利用推导出的数组长度N，生成定长的SIMD查找函数 */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+    item01.hpp中的arraySize说明了：以 T (&)[N] 接收数组时，长度N是模板参数。
+    既然N在编译期已知，查找小表时就没有必要写一个逐元素比较、每步都有分支的循环：
+
+    * find / contains / count / min / max 接收 T (&)[N] 或 std::array<T, N>
+    * 编译期根据 N * sizeof(T) 选择实现：
+        不少于32字节 -> AVX2（每次比较32字节）
+        不少于16字节 -> SSE4.1（每次比较16字节）
+        其余         -> 标量
+      循环的次数是常量，全部展开；不足一个向量的尾部用"与前一块重叠的最后一个向量"处理，不需要逐元素收尾
+    * 编译时没有开启-mavx2/-msse4.1时，SIMD版本用target属性单独编译，
+      调用时检查一次（结果缓存）CPU是否支持，不支持就退回下一级实现
+    * target区域依赖#pragma GCC target，只在GCC上启用；Clang忽略这条pragma，SIMD版本会无法编译，因此走标量
+    * 只有整型元素走SIMD；8字节整型的min/max在AVX2中没有对应指令，走标量
+    * 常量求值（constexpr）时总是走标量实现
+
+    find返回元素下标，找不到返回N（与std::find返回end()的约定一致）
+*/
+
+// item03_gather.hpp、item06_dynamic_bitset.hpp、item06_matmul.hpp的target区域同样以此为条件
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+    #define EMCP_FIXED_SEARCH_SIMD 1
+    #include <immintrin.h>
+#else
+    #define EMCP_FIXED_SEARCH_SIMD 0
+#endif
+
+namespace Item01_FixedSearch
+{
+    // 一、标量实现：N为常量，循环可完全展开；find/min/max写成条件选择，不提前退出
+    namespace Scalar
+    {
+        template<typename T, std::size_t N>
+        constexpr std::size_t find(const T* a, T value) noexcept
+        {
+            std::size_t result = N;
+            for (std::size_t i = N; i-- > 0;) {
+                result = a[i] == value ? i : result;
+            }
+            return result;
+        }
+
+        template<typename T, std::size_t N>
+        constexpr bool contains(const T* a, T value) noexcept
+        {
+            bool found = false;
+            for (std::size_t i = 0; i < N; ++i) found |= a[i] == value;
+            return found;
+        }
+
+        template<typename T, std::size_t N>
+        constexpr std::size_t count(const T* a, T value) noexcept
+        {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < N; ++i) n += a[i] == value;
+            return n;
+        }
+
+        template<typename T, std::size_t N>
+        constexpr T min(const T* a) noexcept
+        {
+            T result = a[0];
+            for (std::size_t i = 1; i < N; ++i) result = a[i] < result ? a[i] : result;
+            return result;
+        }
+
+        template<typename T, std::size_t N>
+        constexpr T max(const T* a) noexcept
+        {
+            T result = a[0];
+            for (std::size_t i = 1; i < N; ++i) result = result < a[i] ? a[i] : result;
+            return result;
+        }
+    }
+
+
+#if EMCP_FIXED_SEARCH_SIMD
+    // 二、SIMD实现
+    // 每个指令集提供一组Ops（load/set1/eq/min/max/movemask），再把通用的内核
+    // item01_fixed_search_kernels.inl 在该指令集的target区域内展开一次。
+    // 内核不能写成以Ops为参数的普通模板：没有target属性的函数无法内联带target属性的intrinsic。
+
+    #pragma GCC push_options
+    #pragma GCC target("sse4.1")
+    namespace Sse41
+    {
+        struct Ops
+        {
+            using Vec = __m128i;
+            static constexpr std::size_t Bytes = 16;
+
+            static Vec load(const void* p) { return _mm_loadu_si128(static_cast<const Vec*>(p)); }
+            static Vec orv(Vec a, Vec b) { return _mm_or_si128(a, b); }
+            static std::uint32_t movemask(Vec a) { return static_cast<std::uint32_t>(_mm_movemask_epi8(a)); }
+
+            template<typename T>
+            static Vec set1(T v)
+            {
+                if constexpr (sizeof(T) == 1) return _mm_set1_epi8(static_cast<char>(v));
+                else if constexpr (sizeof(T) == 2) return _mm_set1_epi16(static_cast<short>(v));
+                else if constexpr (sizeof(T) == 4) return _mm_set1_epi32(static_cast<int>(v));
+                else return _mm_set1_epi64x(static_cast<long long>(v));
+            }
+
+            template<typename T>
+            static Vec eq(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(a, b);
+                else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(a, b);
+                else if constexpr (sizeof(T) == 4) return _mm_cmpeq_epi32(a, b);
+                else return _mm_cmpeq_epi64(a, b);
+            }
+
+            template<typename T>
+            static Vec min(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1) return std::is_signed_v<T> ? _mm_min_epi8(a, b) : _mm_min_epu8(a, b);
+                else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm_min_epi16(a, b) : _mm_min_epu16(a, b);
+                else return std::is_signed_v<T> ? _mm_min_epi32(a, b) : _mm_min_epu32(a, b);
+            }
+
+            template<typename T>
+            static Vec max(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1) return std::is_signed_v<T> ? _mm_max_epi8(a, b) : _mm_max_epu8(a, b);
+                else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm_max_epi16(a, b) : _mm_max_epu16(a, b);
+                else return std::is_signed_v<T> ? _mm_max_epi32(a, b) : _mm_max_epu32(a, b);
+            }
+
+            // 水平归约：每次把向量的高一半折叠到低一半，最后取最低位的元素
+            template<typename T, bool IsMin>
+            static T reduce(Vec v)
+            {
+                auto op = [](Vec a, Vec b) { return IsMin ? min<T>(a, b) : max<T>(a, b); };
+                v = op(v, _mm_srli_si128(v, 8));
+                if constexpr (sizeof(T) <= 4) v = op(v, _mm_srli_si128(v, 4));
+                if constexpr (sizeof(T) <= 2) v = op(v, _mm_srli_si128(v, 2));
+                if constexpr (sizeof(T) == 1) v = op(v, _mm_srli_si128(v, 1));
+                return static_cast<T>(_mm_cvtsi128_si32(v));
+            }
+        };
+
+        #include "item01_fixed_search_kernels.inl"
+    }
+    #pragma GCC pop_options
+
+    #pragma GCC push_options
+    #pragma GCC target("avx2")
+    namespace Avx2
+    {
+        struct Ops
+        {
+            using Vec = __m256i;
+            static constexpr std::size_t Bytes = 32;
+
+            static Vec load(const void* p) { return _mm256_loadu_si256(static_cast<const Vec*>(p)); }
+            static Vec orv(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+            static std::uint32_t movemask(Vec a) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(a)); }
+
+            template<typename T>
+            static Vec set1(T v)
+            {
+                if constexpr (sizeof(T) == 1) return _mm256_set1_epi8(static_cast<char>(v));
+                else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(static_cast<short>(v));
+                else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int>(v));
+                else return _mm256_set1_epi64x(static_cast<long long>(v));
+            }
+
+            template<typename T>
+            static Vec eq(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+                else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+                else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+                else return _mm256_cmpeq_epi64(a, b);
+            }
+
+            template<typename T>
+            static Vec min(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1) return std::is_signed_v<T> ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+                else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+                else return std::is_signed_v<T> ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+            }
+
+            template<typename T>
+            static Vec max(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1) return std::is_signed_v<T> ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+                else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+                else return std::is_signed_v<T> ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+            }
+
+            // 先把256位折叠成128位，再按SSE的方式归约
+            template<typename T, bool IsMin>
+            static T reduce(Vec v)
+            {
+                auto op = [](__m128i a, __m128i b) { return IsMin ? Sse41::Ops::min<T>(a, b) : Sse41::Ops::max<T>(a, b); };
+                auto x = op(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                x = op(x, _mm_srli_si128(x, 8));
+                if constexpr (sizeof(T) <= 4) x = op(x, _mm_srli_si128(x, 4));
+                if constexpr (sizeof(T) <= 2) x = op(x, _mm_srli_si128(x, 2));
+                if constexpr (sizeof(T) == 1) x = op(x, _mm_srli_si128(x, 1));
+                return static_cast<T>(_mm_cvtsi128_si32(x));
+            }
+        };
+
+        #include "item01_fixed_search_kernels.inl"
+    }
+    #pragma GCC pop_options
+#endif
+
+
+    // 三、指令集选择
+    enum class Isa { Scalar, Sse41, Avx2 };
+
+    // 运行时检测，结果缓存；编译时已开启对应指令集则直接为true
+    inline bool hasSse41() noexcept
+    {
+#if defined(__SSE4_1__)
+        return true;
+#elif EMCP_FIXED_SEARCH_SIMD
+        static const bool supported = __builtin_cpu_supports("sse4.1");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    inline bool hasAvx2() noexcept
+    {
+#if defined(__AVX2__)
+        return true;
+#elif EMCP_FIXED_SEARCH_SIMD
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    // 编译期：按元素类型和总字节数选出希望使用的最高指令集
+    template<typename T, std::size_t N, bool NeedMinMax = false>
+    constexpr Isa preferredIsa() noexcept
+    {
+        constexpr bool simdElement = EMCP_FIXED_SEARCH_SIMD
+            && std::is_integral_v<T> && !std::is_same_v<T, bool>
+            && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || (sizeof(T) == 8 && !NeedMinMax));
+
+        if (!simdElement) return Isa::Scalar;
+        if (N * sizeof(T) >= 32) return Isa::Avx2;
+        if (N * sizeof(T) >= 16) return Isa::Sse41;
+        return Isa::Scalar;
+    }
+
+    // 按preferredIsa逐级尝试：编译期排除不适用的级别，运行时排除CPU不支持的级别
+    namespace Detail
+    {
+        template<typename T, std::size_t N>
+        constexpr std::size_t find(const T* a, T value) noexcept
+        {
+#if EMCP_FIXED_SEARCH_SIMD
+            constexpr Isa preferred = preferredIsa<T, N>();
+            if (!std::is_constant_evaluated()) {
+                if constexpr (preferred == Isa::Avx2) { if (hasAvx2()) return Avx2::find<T, N>(a, value); }
+                if constexpr (preferred != Isa::Scalar) { if (hasSse41()) return Sse41::find<T, N>(a, value); }
+            }
+#endif
+            return Scalar::find<T, N>(a, value);
+        }
+
+        template<typename T, std::size_t N>
+        constexpr bool contains(const T* a, T value) noexcept
+        {
+#if EMCP_FIXED_SEARCH_SIMD
+            constexpr Isa preferred = preferredIsa<T, N>();
+            if (!std::is_constant_evaluated()) {
+                if constexpr (preferred == Isa::Avx2) { if (hasAvx2()) return Avx2::contains<T, N>(a, value); }
+                if constexpr (preferred != Isa::Scalar) { if (hasSse41()) return Sse41::contains<T, N>(a, value); }
+            }
+#endif
+            return Scalar::contains<T, N>(a, value);
+        }
+
+        template<typename T, std::size_t N>
+        constexpr std::size_t count(const T* a, T value) noexcept
+        {
+#if EMCP_FIXED_SEARCH_SIMD
+            constexpr Isa preferred = preferredIsa<T, N>();
+            if (!std::is_constant_evaluated()) {
+                if constexpr (preferred == Isa::Avx2) { if (hasAvx2()) return Avx2::count<T, N>(a, value); }
+                if constexpr (preferred != Isa::Scalar) { if (hasSse41()) return Sse41::count<T, N>(a, value); }
+            }
+#endif
+            return Scalar::count<T, N>(a, value);
+        }
+
+        template<typename T, std::size_t N>
+        constexpr T min(const T* a) noexcept
+        {
+            static_assert(N > 0, "空数组没有最小值");
+#if EMCP_FIXED_SEARCH_SIMD
+            constexpr Isa preferred = preferredIsa<T, N, true>();
+            if (!std::is_constant_evaluated()) {
+                if constexpr (preferred == Isa::Avx2) { if (hasAvx2()) return Avx2::min<T, N>(a); }
+                if constexpr (preferred != Isa::Scalar) { if (hasSse41()) return Sse41::min<T, N>(a); }
+            }
+#endif
+            return Scalar::min<T, N>(a);
+        }
+
+        template<typename T, std::size_t N>
+        constexpr T max(const T* a) noexcept
+        {
+            static_assert(N > 0, "空数组没有最大值");
+#if EMCP_FIXED_SEARCH_SIMD
+            constexpr Isa preferred = preferredIsa<T, N, true>();
+            if (!std::is_constant_evaluated()) {
+                if constexpr (preferred == Isa::Avx2) { if (hasAvx2()) return Avx2::max<T, N>(a); }
+                if constexpr (preferred != Isa::Scalar) { if (hasSse41()) return Sse41::max<T, N>(a); }
+            }
+#endif
+            return Scalar::max<T, N>(a);
+        }
+    }
+
+
+    // 四、对外接口：与arraySize一样用 T (&)[N] 推导长度，std::array的长度同样是模板参数
+    template<typename T, std::size_t N>
+    constexpr std::size_t find(const T (&a)[N], const T& value) noexcept { return Detail::find<T, N>(a, value); }
+
+    template<typename T, std::size_t N>
+    constexpr std::size_t find(const std::array<T, N>& a, const T& value) noexcept { return Detail::find<T, N>(a.data(), value); }
+
+    template<typename T, std::size_t N>
+    constexpr bool contains(const T (&a)[N], const T& value) noexcept { return Detail::contains<T, N>(a, value); }
+
+    template<typename T, std::size_t N>
+    constexpr bool contains(const std::array<T, N>& a, const T& value) noexcept { return Detail::contains<T, N>(a.data(), value); }
+
+    template<typename T, std::size_t N>
+    constexpr std::size_t count(const T (&a)[N], const T& value) noexcept { return Detail::count<T, N>(a, value); }
+
+    template<typename T, std::size_t N>
+    constexpr std::size_t count(const std::array<T, N>& a, const T& value) noexcept { return Detail::count<T, N>(a.data(), value); }
+
+    template<typename T, std::size_t N>
+    constexpr T min(const T (&a)[N]) noexcept { return Detail::min<T, N>(a); }
+
+    template<typename T, std::size_t N>
+    constexpr T min(const std::array<T, N>& a) noexcept { return Detail::min<T, N>(a.data()); }
+
+    template<typename T, std::size_t N>
+    constexpr T max(const T (&a)[N]) noexcept { return Detail::max<T, N>(a); }
+
+    template<typename T, std::size_t N>
+    constexpr T max(const std::array<T, N>& a) noexcept { return Detail::max<T, N>(a.data()); }
+
+    inline void test()
+    {
+        static constexpr int keyVals[] = { 1, 3, 7, 9, 11, 22, 35 };
+        static_assert(find(keyVals, 9) == 3);
+        static_assert(find(keyVals, 8) == 7);
+
+        std::array<std::uint8_t, 48> table{};
+        table[40] = 7;
+        auto i = find(table, std::uint8_t{ 7 });    // 48字节，AVX2
+        auto n = count(table, std::uint8_t{ 0 });   // 47
+        auto m = max(table);                        // 7
+        (void)i; (void)n; (void)m;
+    }
+}
+
+// 总结
+// * 数组长度是模板参数时，循环次数、尾部处理方式、使用哪种向量宽度都可以在编译期决定
+// * 16~64项的小表，一两次向量比较就能完成查找，不再有逐元素的分支
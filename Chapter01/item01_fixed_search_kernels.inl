@@ -0,0 +1,102 @@
+/* 条款1 扩展 - 定长SIMD查找的通用内核（由item01_fixed_search.hpp在各指令集的target区域内包含） */
+
+// 此文件没有include保护：每包含一次，就在当前命名空间中以当前的Ops生成一套内核。
+// 要求：L = Ops::Bytes / sizeof(T) 且 N >= L。
+// 尾部不足一个向量时，加载[N - L, N)这一块，它与前一块重叠；find/contains/min/max不受重叠影响，
+// count需要屏蔽重叠部分的比较结果。
+
+template<typename T, std::size_t N>
+std::size_t find(const T* a, T value) noexcept
+{
+    constexpr std::size_t L = Ops::Bytes / sizeof(T);
+    static_assert(N >= L, "数组不足一个向量，应使用标量实现");
+
+    const auto needle = Ops::set1<T>(value);
+
+#pragma GCC unroll 64
+    for (std::size_t i = 0; i + L <= N; i += L) {
+        auto mask = Ops::movemask(Ops::eq<T>(Ops::load(a + i), needle));
+        if (mask != 0) return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+    }
+
+    if constexpr (N % L != 0) {
+        constexpr std::size_t i = N - L;
+        auto mask = Ops::movemask(Ops::eq<T>(Ops::load(a + i), needle));
+        if (mask != 0) return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+    }
+    return N;
+}
+
+template<typename T, std::size_t N>
+bool contains(const T* a, T value) noexcept
+{
+    constexpr std::size_t L = Ops::Bytes / sizeof(T);
+    static_assert(N >= L, "数组不足一个向量，应使用标量实现");
+
+    const auto needle = Ops::set1<T>(value);
+    auto hits = Ops::eq<T>(Ops::load(a + N - L), needle);
+
+#pragma GCC unroll 64
+    for (std::size_t i = 0; i + L <= N; i += L) {
+        hits = Ops::orv(hits, Ops::eq<T>(Ops::load(a + i), needle));
+    }
+    return Ops::movemask(hits) != 0;
+}
+
+template<typename T, std::size_t N>
+std::size_t count(const T* a, T value) noexcept
+{
+    constexpr std::size_t L = Ops::Bytes / sizeof(T);
+    static_assert(N >= L, "数组不足一个向量，应使用标量实现");
+
+    const auto needle = Ops::set1<T>(value);
+    std::size_t bits = 0;
+
+#pragma GCC unroll 64
+    for (std::size_t i = 0; i + L <= N; i += L) {
+        bits += static_cast<std::size_t>(std::popcount(Ops::movemask(Ops::eq<T>(Ops::load(a + i), needle))));
+    }
+
+    if constexpr (N % L != 0) {
+        // 最后一块的前 (L - N % L) 个元素已经统计过
+        constexpr std::size_t overlapBytes = (L - N % L) * sizeof(T);
+        constexpr std::uint32_t keep = ~((std::uint32_t(1) << overlapBytes) - 1);
+        auto mask = Ops::movemask(Ops::eq<T>(Ops::load(a + N - L), needle)) & keep;
+        bits += static_cast<std::size_t>(std::popcount(mask));
+    }
+
+    // movemask每个字节一位，一个元素占sizeof(T)位
+    return bits / sizeof(T);
+}
+
+template<typename T, std::size_t N>
+T min(const T* a) noexcept
+{
+    constexpr std::size_t L = Ops::Bytes / sizeof(T);
+    static_assert(N >= L, "数组不足一个向量，应使用标量实现");
+
+    auto acc = Ops::load(a + N - L);
+
+#pragma GCC unroll 64
+    for (std::size_t i = 0; i + L <= N; i += L) {
+        acc = Ops::min<T>(acc, Ops::load(a + i));
+    }
+
+    return Ops::reduce<T, true>(acc);
+}
+
+template<typename T, std::size_t N>
+T max(const T* a) noexcept
+{
+    constexpr std::size_t L = Ops::Bytes / sizeof(T);
+    static_assert(N >= L, "数组不足一个向量，应使用标量实现");
+
+    auto acc = Ops::load(a + N - L);
+
+#pragma GCC unroll 64
+    for (std::size_t i = 0; i + L <= N; i += L) {
+        acc = Ops::max<T>(acc, Ops::load(a + i));
+    }
+
+    return Ops::reduce<T, false>(acc);
+}
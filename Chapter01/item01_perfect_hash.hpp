@@ -0,0 +1,251 @@
+/* 条款1 扩展 - 用arraySize推导出的键数组，在编译期构造完美哈希表 */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+/*
+    item01.hpp的TempalteTypeDedution7::test2中：
+
+        int keyVals[] = { 1, 3, 7, 9, 11, 22, 35 };
+        int mappedVals[arraySize(keyVals)];
+
+    数组长度N通过 T (&)[N] 在编译期就已知，但keyVals到mappedVals之间并没有映射。
+    这里同样以 T (&)[N] 接收键数组，在编译期（constexpr求值）搜索出一组无冲突的哈希参数：
+
+    * 采用"哈希-位移"（hash and displace）两级方案：
+        h      = mix(key ^ seed)
+        bucket = 高32位 & (BucketCount - 1)
+        slot   = (低32位 ^ displacement[bucket]) & (TableSize - 1)
+      构造时按桶从大到小为每个桶寻找一个位移值，使桶内所有键都落到空槽位；
+      查找时只有两次数组访问，没有探测，也没有分支（命中与否用条件选择返回）
+    * 整个对象是字面值类型，声明为constexpr后存放在只读数据段（.rodata）
+    * 参数找不到或键重复时抛出异常，在常量求值中表现为编译错误
+
+    用法：
+        static constexpr int keyVals[] = { 1, 3, 7, 9, 11, 22, 35 };
+        static constexpr int mappedVals[arraySize(keyVals)] = { ... };
+
+        constexpr auto routes = makePerfectHashMap(keyVals, mappedVals);
+        static_assert(*routes.find(9) == mappedVals[3]);
+
+        constexpr auto index = makePerfectHashMap(keyVals);   // 键 -> 在keyVals中的下标
+*/
+
+namespace Item01_PerfectHash
+{
+    // 一、键到64位整数的转换：整型/枚举直接转换，字符串使用FNV-1a
+    template<typename Key>
+    constexpr std::uint64_t keyBits(const Key& key) noexcept
+    {
+        static_assert(std::is_integral_v<Key> || std::is_enum_v<Key>,
+                      "PerfectHashMap只支持整型、枚举和std::string_view键");
+        return static_cast<std::uint64_t>(key);
+    }
+
+    constexpr std::uint64_t keyBits(std::string_view key) noexcept
+    {
+        std::uint64_t h = 14695981039346656037ull;
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // splitmix64的终结函数，把键的位充分打散
+    constexpr std::uint64_t mix(std::uint64_t x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+
+    // 二、完美哈希表
+    template<typename Key, typename Value, std::size_t N>
+    class PerfectHashMap
+    {
+        static_assert(N > 0, "键数组不能为空");
+
+    public:
+        // 装载因子不超过3/4，两者都取2的幂以便用掩码代替取模
+        static constexpr std::size_t TableSize =
+            std::bit_ceil(N) * (N * 4 > std::bit_ceil(N) * 3 ? 2 : 1);
+        static constexpr std::size_t BucketCount = std::bit_ceil((N + 1) / 2);
+
+        constexpr PerfectHashMap(const Key (&keys)[N], const Value (&values)[N])
+        {
+            for (std::size_t i = 0; i < N; ++i) {
+                for (std::size_t j = i + 1; j < N; ++j) {
+                    if (keys[i] == keys[j]) throw std::logic_error("PerfectHashMap: 键重复");
+                }
+            }
+
+            for (std::uint64_t attempt = 0; attempt < 64; ++attempt) {
+                seed = mix(attempt + 0x9e3779b97f4a7c15ull);
+                if (build(keys, values)) return;
+            }
+            throw std::logic_error("PerfectHashMap: 找不到无冲突的哈希参数");
+        }
+
+        // 未命中返回nullptr
+        constexpr const Value* find(const Key& key) const noexcept
+        {
+            auto s = slotOf(key);
+            return hit(s, key) ? &slotValues[s] : nullptr;
+        }
+
+        constexpr bool contains(const Key& key) const noexcept
+        {
+            return hit(slotOf(key), key);
+        }
+
+        // 无分支查找：未命中时返回fallback
+        constexpr Value lookup(const Key& key, Value fallback) const noexcept
+        {
+            auto s = slotOf(key);
+            return hit(s, key) ? slotValues[s] : fallback;
+        }
+
+        static constexpr std::size_t size() noexcept { return N; }
+
+    private:
+        constexpr std::uint64_t hashOf(const Key& key) const noexcept
+        {
+            return mix(keyBits(key) ^ seed);
+        }
+
+        static constexpr std::size_t bucketOf(std::uint64_t h) noexcept
+        {
+            return static_cast<std::size_t>(h >> 32) & (BucketCount - 1);
+        }
+
+        constexpr std::size_t slotOf(const Key& key) const noexcept
+        {
+            auto h = hashOf(key);
+            return (static_cast<std::uint32_t>(h) ^ displacement[bucketOf(h)]) & (TableSize - 1);
+        }
+
+        // 用按位与而非&&，避免短路求值引入分支
+        constexpr bool hit(std::size_t s, const Key& key) const noexcept
+        {
+            return used[s] & (slotKeys[s] == key);
+        }
+
+        constexpr bool build(const Key (&keys)[N], const Value (&values)[N])
+        {
+            std::array<std::size_t, BucketCount> bucketSize{};
+            std::array<std::size_t, N> bucketOfKey{};
+            std::size_t maxBucketSize = 0;
+
+            for (std::size_t i = 0; i < N; ++i) {
+                bucketOfKey[i] = bucketOf(hashOf(keys[i]));
+                auto n = ++bucketSize[bucketOfKey[i]];
+                if (n > maxBucketSize) maxBucketSize = n;
+            }
+
+            used.fill(false);
+            displacement.fill(0);
+            slotKeys.fill(Key{});
+            slotValues.fill(Value{});
+
+            // 先安置大桶：大桶可选的位移最少
+            std::array<std::size_t, N> members{};
+            for (std::size_t size = maxBucketSize; size > 0; --size) {
+                for (std::size_t b = 0; b < BucketCount; ++b) {
+                    if (bucketSize[b] != size) continue;
+
+                    std::size_t count = 0;
+                    for (std::size_t i = 0; i < N; ++i) {
+                        if (bucketOfKey[i] == b) members[count++] = i;
+                    }
+                    if (!place(keys, values, members, count, b)) return false;
+                }
+            }
+            return true;
+        }
+
+        // 为桶b寻找位移值d，使桶内count个键落在互不相同的空槽位上
+        constexpr bool place(const Key (&keys)[N], const Value (&values)[N],
+                             const std::array<std::size_t, N>& members, std::size_t count,
+                             std::size_t b)
+        {
+            std::array<std::size_t, N> slots{};
+
+            for (std::uint32_t d = 0; d < TableSize; ++d) {
+                bool fits = true;
+                for (std::size_t m = 0; m < count && fits; ++m) {
+                    auto s = (static_cast<std::uint32_t>(hashOf(keys[members[m]])) ^ d) & (TableSize - 1);
+                    fits = !used[s];
+                    for (std::size_t k = 0; k < m && fits; ++k) fits = slots[k] != s;
+                    slots[m] = s;
+                }
+                if (!fits) continue;
+
+                displacement[b] = d;
+                for (std::size_t m = 0; m < count; ++m) {
+                    used[slots[m]] = true;
+                    slotKeys[slots[m]] = keys[members[m]];
+                    slotValues[slots[m]] = values[members[m]];
+                }
+                return true;
+            }
+            return false;
+        }
+
+        std::uint64_t seed = 0;
+        std::array<std::uint32_t, BucketCount> displacement{};
+        std::array<bool, TableSize> used{};
+        std::array<Key, TableSize> slotKeys{};
+        std::array<Value, TableSize> slotValues{};
+    };
+
+
+    // 三、工厂函数：与arraySize一样，用 T (&)[N] 推导出键数组的长度
+    template<typename Key, typename Value, std::size_t N>
+    constexpr auto makePerfectHashMap(const Key (&keys)[N], const Value (&values)[N])
+    {
+        return PerfectHashMap<Key, Value, N>(keys, values);
+    }
+
+    // 只给出键数组时，映射到键在数组中的下标，正好用来索引 mappedVals[arraySize(keyVals)]
+    template<typename Key, std::size_t N>
+    constexpr auto makePerfectHashMap(const Key (&keys)[N])
+    {
+        std::size_t indices[N]{};
+        for (std::size_t i = 0; i < N; ++i) indices[i] = i;
+        return PerfectHashMap<Key, std::size_t, N>(keys, indices);
+    }
+
+    inline void test()
+    {
+        static constexpr int keyVals[] = { 1, 3, 7, 9, 11, 22, 35 };
+        static constexpr int mappedVals[] = { 10, 30, 70, 90, 110, 220, 350 };
+
+        static constexpr auto routes = makePerfectHashMap(keyVals, mappedVals);
+        static_assert(routes.lookup(22, -1) == 220);
+        static_assert(routes.lookup(23, -1) == -1);
+
+        static constexpr auto index = makePerfectHashMap(keyVals);
+        static_assert(*index.find(35) == 6);
+
+        static constexpr std::string_view names[] = { "get", "put", "post", "delete" };
+        static constexpr auto methods = makePerfectHashMap(names);
+        static_assert(methods.contains(std::string_view("post")));
+        static_assert(!methods.contains(std::string_view("head")));
+    }
+}
+
+// 总结
+// * T (&)[N] 让键数组的长度成为模板参数，哈希表的大小因而也是编译期常量
+// * 构造函数是constexpr，参数搜索在编译期完成，结果可以整体放进只读数据段
+// * 查找是两次数组访问加一次比较，没有探测循环
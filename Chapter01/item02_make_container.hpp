@@ -0,0 +1,111 @@
+/* 条款2 扩展 - 可移动的"列表初始化"：make_container / emplace_list */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item02.hpp中：
+
+        auto x3 = { 18 };                               // std::initializer_list<int>
+        template<typename T>
+        void f(std::initializer_list<T> param);
+
+    std::initializer_list只提供const元素，所以：
+    * std::vector<std::string> v{ s1, s2, s3 }; 先把每个实参构造进initializer_list的底层数组，
+      再从这个const数组逐个拷贝到vector —— 每个长字符串都多了一次分配和拷贝
+    * std::vector<std::unique_ptr<T>> v{ ... }; 根本无法通过编译，因为unique_ptr不能拷贝
+
+    这里用可变参数模板（参见条款7的doSomeWork）代替initializer_list：
+    * make_container<C>(args...)      构造一个C，先reserve(sizeof...(args))，再把每个实参完美转发进去
+    * make_container<std::vector>(args...) 由实参推导元素类型（std::common_type）
+    * emplace_list(c, args...)        向已有容器追加，容量不够时才reserve一次，且至少翻倍：
+                                      在循环中反复追加时仍是均摊O(1)，不会每次都重新分配
+    按容器提供的接口依次选择 emplace_back -> emplace -> insert。
+*/
+
+namespace Item02_MakeContainer
+{
+    namespace Detail
+    {
+        template<typename C>
+        concept HasReserve = requires(C& c, std::size_t n) { c.reserve(n); };
+
+        template<typename C>
+        concept HasSize = requires(const C& c) { c.size(); };
+
+        template<typename C>
+        concept HasCapacity = requires(const C& c) { c.capacity(); };
+
+        template<typename C, typename Arg>
+        void emplaceOne(C& c, Arg&& arg)
+        {
+            if constexpr (requires { c.emplace_back(std::forward<Arg>(arg)); }) {
+                c.emplace_back(std::forward<Arg>(arg));
+            }
+            else if constexpr (requires { c.emplace(std::forward<Arg>(arg)); }) {
+                c.emplace(std::forward<Arg>(arg));       // set、map等关联容器
+            }
+            else {
+                c.insert(c.end(), std::forward<Arg>(arg));
+            }
+        }
+    }
+
+    // 向已有容器追加：至多reserve一次，然后逐个转发
+    template<typename C, typename... Args>
+    C& emplace_list(C& c, Args&&... args)
+    {
+        if constexpr (Detail::HasReserve<C> && Detail::HasSize<C> && Detail::HasCapacity<C>) {
+            // 恰好reserve到size + N会让循环追加每次都重新分配（O(n²)），所以不够时按几何增长
+            const std::size_t need = c.size() + sizeof...(Args);
+            if (need > c.capacity()) c.reserve(std::max(need, 2 * c.capacity()));
+        }
+        else if constexpr (Detail::HasReserve<C> && Detail::HasSize<C>) {
+            c.reserve(c.size() + sizeof...(Args));      // unordered容器：元素数已够时不会重新散列
+        }
+        (Detail::emplaceOne(c, std::forward<Args>(args)), ...);
+        return c;
+    }
+
+    // 指定容器类型：make_container<std::vector<std::string>>(std::move(a), "b", std::string(64, 'c'))
+    template<typename C, typename... Args>
+    C make_container(Args&&... args)
+    {
+        C c;
+        emplace_list(c, std::forward<Args>(args)...);
+        return c;
+    }
+
+    // 只指定容器模板：元素类型由实参推导，make_container<std::vector>(std::make_unique<int>(1), ...)
+    template<template<typename...> class C, typename... Args>
+    auto make_container(Args&&... args)
+    {
+        static_assert(sizeof...(Args) > 0, "没有实参时无法推导元素类型");
+        using T = std::common_type_t<std::decay_t<Args>...>;
+        return make_container<C<T>>(std::forward<Args>(args)...);
+    }
+
+    inline void test()
+    {
+        std::string s1(64, 'a');
+
+        // 长字符串被移动进去，而不是从initializer_list拷贝
+        auto names = make_container<std::vector<std::string>>(std::move(s1), "short", std::string(64, 'b'));
+
+        // std::vector<std::unique_ptr<int>> v{ ... }; 无法编译，这里可以
+        auto owners = make_container<std::vector>(std::make_unique<int>(1), std::make_unique<int>(2));
+
+        emplace_list(owners, std::make_unique<int>(3));
+    }
+}
+
+// 总结
+// * std::initializer_list的元素是const的，花括号初始化只能拷贝，移动语义在这里失效
+// * 可变参数模板 + 完美转发既能移动，也能原地构造，还能预先reserve
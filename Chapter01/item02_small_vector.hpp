@@ -0,0 +1,490 @@
+/* 条款2 扩展 - 内联存储的small_vector，承接花括号初始化的短列表 */
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+    AutoTypeDedution4::TestLambdaAuto中：
+
+        std::vector<int> v;
+        ... v = { 1, 2, 3 };
+
+    AutoTypeDedution2中也到处是 { 18 }、{ 1, 2, 3 } 这样的短列表。
+    每次把它们放进std::vector都要堆分配一次，哪怕只有一两个元素。
+
+    small_vector<T, InlineN>：
+    * 前InlineN个元素存放在对象内部的缓冲区，不分配堆内存；超出后才转移到堆上
+    * 接口与std::vector一致（构造、赋值、assign、元素访问、迭代器、容量、insert/erase/emplace、比较）
+    * 扩容时用std::move_if_noexcept搬运元素（参见条款14），移动构造可能抛异常的类型退回到拷贝
+    * 迭代器就是裸指针；转移到堆上或扩容后，之前的迭代器、指针、引用全部失效（与std::vector相同）
+*/
+
+namespace Item02_SmallVector
+{
+    template<typename T, std::size_t InlineN>
+    class small_vector
+    {
+    public:
+        using value_type             = T;
+        using size_type              = std::size_t;
+        using difference_type        = std::ptrdiff_t;
+        using reference              = T&;
+        using const_reference        = const T&;
+        using pointer                = T*;
+        using const_pointer          = const T*;
+        using iterator               = T*;
+        using const_iterator         = const T*;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type inline_capacity = InlineN;
+
+        // 一、构造、析构与赋值
+        small_vector() noexcept = default;
+
+        explicit small_vector(size_type count) { resize(count); }
+
+        small_vector(size_type count, const T& value) { assign(count, value); }
+
+        template<typename InputIt,
+                 typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        small_vector(InputIt first, InputIt last) { assign(first, last); }
+
+        small_vector(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+        small_vector(const small_vector& rhs) { assign(rhs.begin(), rhs.end()); }
+
+        small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            takeFrom(std::move(rhs));
+        }
+
+        ~small_vector()
+        {
+            clear();
+            releaseHeap();
+        }
+
+        small_vector& operator=(const small_vector& rhs)
+        {
+            if (this != &rhs) assign(rhs.begin(), rhs.end());
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &rhs) {
+                clear();
+                releaseHeap();
+                takeFrom(std::move(rhs));
+            }
+            return *this;
+        }
+
+        // v = { 1, 2, 3 }：元素个数不超过InlineN时不分配
+        small_vector& operator=(std::initializer_list<T> il)
+        {
+            assign(il.begin(), il.end());
+            return *this;
+        }
+
+        void assign(size_type count, const T& value)
+        {
+            if (count > capacity()) {
+                small_vector tmp;
+                tmp.reserve(count);
+                std::uninitialized_fill_n(tmp.ptr, count, value);
+                tmp.sz = count;
+                swap(tmp);
+                return;
+            }
+
+            auto common = std::min(count, sz);
+            std::fill_n(ptr, common, value);
+            if (count > sz) std::uninitialized_fill_n(ptr + sz, count - sz, value);
+            else std::destroy(ptr + count, ptr + sz);
+            sz = count;
+        }
+
+        template<typename InputIt,
+                 typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        void assign(InputIt first, InputIt last)
+        {
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+                auto count = static_cast<size_type>(std::distance(first, last));
+                if (count > capacity()) {
+                    small_vector tmp;
+                    tmp.reserve(count);
+                    std::uninitialized_copy(first, last, tmp.ptr);
+                    tmp.sz = count;
+                    swap(tmp);
+                    return;
+                }
+
+                // 先覆盖已有元素，再在尾部构造或析构
+                auto common = std::min(count, sz);
+                auto mid = std::next(first, static_cast<difference_type>(common));
+                std::copy(first, mid, ptr);
+                if (count > sz) std::uninitialized_copy(mid, last, ptr + sz);
+                else std::destroy(ptr + count, ptr + sz);
+                sz = count;
+            }
+            else {
+                clear();
+                for (; first != last; ++first) emplace_back(*first);
+            }
+        }
+
+        void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+
+        // 二、元素访问
+        reference at(size_type pos)
+        {
+            if (pos >= sz) throw std::out_of_range("small_vector::at");
+            return ptr[pos];
+        }
+
+        const_reference at(size_type pos) const
+        {
+            if (pos >= sz) throw std::out_of_range("small_vector::at");
+            return ptr[pos];
+        }
+
+        reference operator[](size_type pos) noexcept { return ptr[pos]; }
+        const_reference operator[](size_type pos) const noexcept { return ptr[pos]; }
+
+        reference front() noexcept { return ptr[0]; }
+        const_reference front() const noexcept { return ptr[0]; }
+        reference back() noexcept { return ptr[sz - 1]; }
+        const_reference back() const noexcept { return ptr[sz - 1]; }
+
+        T* data() noexcept { return ptr; }
+        const T* data() const noexcept { return ptr; }
+
+
+        // 三、迭代器
+        iterator begin() noexcept { return ptr; }
+        const_iterator begin() const noexcept { return ptr; }
+        const_iterator cbegin() const noexcept { return ptr; }
+        iterator end() noexcept { return ptr + sz; }
+        const_iterator end() const noexcept { return ptr + sz; }
+        const_iterator cend() const noexcept { return ptr + sz; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+
+        // 四、容量
+        bool empty() const noexcept { return sz == 0; }
+        size_type size() const noexcept { return sz; }
+        size_type capacity() const noexcept { return cap; }
+        size_type max_size() const noexcept { return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>()); }
+
+        // 元素是否仍在内联缓冲区中
+        bool is_inline() const noexcept { return ptr == inlineData(); }
+
+        void reserve(size_type newCap)
+        {
+            if (newCap > cap) reallocate(newCap);
+        }
+
+        // 元素个数不超过InlineN时搬回内联缓冲区
+        void shrink_to_fit()
+        {
+            if (is_inline() || sz == cap) return;
+
+            if (sz <= InlineN) {
+                auto heap = ptr;
+                auto heapCap = cap;
+                relocate(heap, sz, inlineData());
+                ptr = inlineData();
+                cap = InlineN;
+                std::allocator<T>().deallocate(heap, heapCap);
+            }
+            else {
+                reallocate(sz);
+            }
+        }
+
+
+        // 五、修改
+        void clear() noexcept
+        {
+            std::destroy(ptr, ptr + sz);
+            sz = 0;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        template<typename... Args>
+        reference emplace_back(Args&&... args)
+        {
+            if (sz == cap) return growAndEmplaceBack(std::forward<Args>(args)...);
+
+            ::new (static_cast<void*>(ptr + sz)) T(std::forward<Args>(args)...);
+            return ptr[sz++];
+        }
+
+        void pop_back() noexcept
+        {
+            std::destroy_at(ptr + --sz);
+        }
+
+        // 插入统一先追加到尾部，再rotate到目标位置
+        template<typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            auto index = pos - cbegin();
+            emplace_back(std::forward<Args>(args)...);
+            std::rotate(begin() + index, end() - 1, end());
+            return begin() + index;
+        }
+
+        iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+        iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+        iterator insert(const_iterator pos, size_type count, const T& value)
+        {
+            auto index = pos - cbegin();
+            auto oldSize = sz;
+            if (sz + count > cap) {
+                T copy(value);          // value可能引用自身元素，扩容前先复制
+                reserve(growthFor(sz + count));
+                for (size_type i = 0; i < count; ++i) emplace_back(copy);
+            }
+            else {
+                for (size_type i = 0; i < count; ++i) emplace_back(value);
+            }
+            std::rotate(begin() + index, begin() + oldSize, end());
+            return begin() + index;
+        }
+
+        template<typename InputIt,
+                 typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            auto index = pos - cbegin();
+            auto oldSize = sz;
+
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+                reserve(growthFor(sz + static_cast<size_type>(std::distance(first, last))));
+            }
+            for (; first != last; ++first) emplace_back(*first);
+
+            std::rotate(begin() + index, begin() + oldSize, end());
+            return begin() + index;
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> il)
+        {
+            return insert(pos, il.begin(), il.end());
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            auto f = begin() + (first - cbegin());
+            auto l = begin() + (last - cbegin());
+            if (f != l) {
+                auto newEnd = std::move(l, end(), f);
+                std::destroy(newEnd, end());
+                sz -= static_cast<size_type>(l - f);
+            }
+            return f;
+        }
+
+        void resize(size_type count)
+        {
+            if (count < sz) {
+                std::destroy(ptr + count, ptr + sz);
+                sz = count;
+                return;
+            }
+            reserve(count);
+            std::uninitialized_value_construct(ptr + sz, ptr + count);
+            sz = count;
+        }
+
+        void resize(size_type count, const T& value)
+        {
+            if (count < sz) {
+                std::destroy(ptr + count, ptr + sz);
+                sz = count;
+                return;
+            }
+            if (count > cap) {
+                T copy(value);
+                reserve(count);
+                std::uninitialized_fill(ptr + sz, ptr + count, copy);
+            }
+            else {
+                std::uninitialized_fill(ptr + sz, ptr + count, value);
+            }
+            sz = count;
+        }
+
+        // 两边都在堆上时只交换指针；否则借助移动完成
+        void swap(small_vector& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this == &rhs) return;
+
+            if (!is_inline() && !rhs.is_inline()) {
+                std::swap(ptr, rhs.ptr);
+                std::swap(sz, rhs.sz);
+                std::swap(cap, rhs.cap);
+                return;
+            }
+
+            small_vector tmp(std::move(rhs));
+            rhs = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        friend void swap(small_vector& a, small_vector& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+
+        // 六、比较
+        friend bool operator==(const small_vector& a, const small_vector& b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+
+        friend auto operator<=>(const small_vector& a, const small_vector& b)
+            requires std::three_way_comparable<T>
+        {
+            return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+        }
+
+    private:
+        T* inlineData() noexcept { return reinterpret_cast<T*>(buffer); }
+        const T* inlineData() const noexcept { return reinterpret_cast<const T*>(buffer); }
+
+        size_type growthFor(size_type needed) const noexcept
+        {
+            return std::max(needed, cap * 2);
+        }
+
+        // 把count个元素从src搬到dst（未初始化内存），并析构src中的元素
+        static void relocate(T* src, size_type count, T* dst)
+        {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+                std::uninitialized_move(src, src + count, dst);
+            }
+            else {
+                std::uninitialized_copy(src, src + count, dst);
+            }
+            std::destroy(src, src + count);
+        }
+
+        void reallocate(size_type newCap)
+        {
+            auto fresh = std::allocator<T>().allocate(newCap);
+            try {
+                relocate(ptr, sz, fresh);
+            }
+            catch (...) {
+                std::allocator<T>().deallocate(fresh, newCap);
+                throw;
+            }
+            releaseHeap();
+            ptr = fresh;
+            cap = newCap;
+        }
+
+        // 先在新内存上构造新元素，再搬运旧元素：args可能引用自身的元素
+        template<typename... Args>
+        reference growAndEmplaceBack(Args&&... args)
+        {
+            auto newCap = growthFor(sz + 1);
+            auto fresh = std::allocator<T>().allocate(newCap);
+            try {
+                ::new (static_cast<void*>(fresh + sz)) T(std::forward<Args>(args)...);
+                try {
+                    relocate(ptr, sz, fresh);
+                }
+                catch (...) {
+                    std::destroy_at(fresh + sz);
+                    throw;
+                }
+            }
+            catch (...) {
+                std::allocator<T>().deallocate(fresh, newCap);
+                throw;
+            }
+            releaseHeap();
+            ptr = fresh;
+            cap = newCap;
+            return ptr[sz++];
+        }
+
+        void releaseHeap() noexcept
+        {
+            if (!is_inline()) {
+                std::allocator<T>().deallocate(ptr, cap);
+                ptr = inlineData();
+                cap = InlineN;
+            }
+        }
+
+        // 要求*this为空且在内联状态
+        void takeFrom(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (!rhs.is_inline()) {
+                ptr = rhs.ptr;
+                sz = rhs.sz;
+                cap = rhs.cap;
+                rhs.ptr = rhs.inlineData();
+                rhs.sz = 0;
+                rhs.cap = InlineN;
+                return;
+            }
+
+            std::uninitialized_move(rhs.ptr, rhs.ptr + rhs.sz, ptr);
+            sz = rhs.sz;
+            rhs.clear();
+        }
+
+        T* ptr = inlineData();
+        size_type sz = 0;
+        size_type cap = InlineN;
+        alignas(T) unsigned char buffer[sizeof(T) * (InlineN > 0 ? InlineN : 1)];
+    };
+
+    inline void test()
+    {
+        small_vector<int, 4> v;
+
+        auto reset = [&v](auto param) { return v = param; };
+        reset(std::initializer_list<int>{ 1, 2, 3 });     // 3个元素，仍在内联缓冲区
+
+        v.push_back(4);
+        v.push_back(5);                                   // 超出4个，转移到堆上
+    }
+}
+
+// 总结
+// * 绝大多数花括号列表都很短，small_vector让它们留在栈上（或所在对象内）
+// * InlineN是编译期参数，需要按实际的元素个数分布来选；选得过大会让对象本身变大，移动也更贵
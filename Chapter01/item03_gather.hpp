@@ -0,0 +1,253 @@
+/* 条款3 扩展 - 批量版本的getValue：getValues(container, indices, out) */
+
+#pragma once
+
+#include "item01_fixed_search.hpp"          // EMCP_FIXED_SEARCH_SIMD、hasAvx2()
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item03.hpp中的getValue每次只取一个元素：
+
+        template<typename Container, typename Index>
+        decltype(auto) getValue(Container&& c, Index i)
+        {
+            return std::forward<Container>(c)[i];
+        }
+
+    按下标批量取值时（一批几千个下标），逐个调用的开销主要不在函数调用，而在访存：
+    * std::deque的c[i]要先算出所在的块，再到块里取元素（两级寻址），随机下标下几乎每次都是缓存未命中
+    * std::vector的c[i]只有一级寻址，但同样是随机访存
+
+    getValues(c, indices, out) 把整批下标一次交给容器，按容器的形态选择实现：
+    * 连续容器 + 4/8字节算术元素 + 4/8字节整型下标 + 输出为同类型的连续迭代器
+        -> AVX2 gather，一条指令取4或8个元素（CPU不支持AVX2时退回下面的实现）
+    * 其余能取到元素地址的随机访问容器（std::deque等分段容器）
+        -> 提前PrefetchDistance个下标发出软件预取，等真正读取时数据已经在路上
+    * 其它情况（std::vector<bool>的代理引用、std::map的operator[]……）
+        -> 逐个 *out++ = std::forward<Container>(c)[i]
+
+    标量路径取元素的表达式与DecltypeDeductions5::getValue完全相同，
+    所以写进out的就是decltype(auto)推导出的那个类型（T&、const T&或代理对象），
+    不会因为先用auto接住而多一次拷贝，也不会把代理对象退化成错误的类型。
+
+    与operator[]一样不检查下标越界。返回值与std::copy一致：指向最后一个写入位置之后的迭代器。
+*/
+
+namespace Item03_Gather
+{
+    // 预取距离：太近数据来不及到达，太远会在用到之前被挤出L1
+    inline constexpr std::size_t PrefetchDistance = 16;
+
+    inline void prefetch(const void* p) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p, 0, 3);
+#else
+        (void)p;
+#endif
+    }
+
+    // 一、AVX2 gather
+    // 每次处理一组下标，返回已经处理的个数（Lanes的整数倍），不足一组的尾部由调用方用标量收尾。
+    // 下标按有符号数解释：4字节下标要求容器长度不超过INT32_MAX（调用方检查），8字节下标没有实际限制。
+#if EMCP_FIXED_SEARCH_SIMD
+    #pragma GCC push_options
+    #pragma GCC target("avx2")
+    namespace Avx2
+    {
+        template<std::size_t ValueBytes, std::size_t IndexBytes>
+        std::size_t gather(const void* base, const void* indices, void* out, std::size_t n) noexcept
+        {
+            const auto* idx = static_cast<const char*>(indices);
+            auto* dst = static_cast<char*>(out);
+            std::size_t k = 0;
+
+            if constexpr (ValueBytes == 4 && IndexBytes == 4) {
+                // 8个32位下标 -> 8个32位元素
+                for (; k + 8 <= n; k += 8) {
+                    auto vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k * 4));
+                    auto v = _mm256_i32gather_epi32(static_cast<const int*>(base), vi, 4);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k * 4), v);
+                }
+            }
+            else if constexpr (ValueBytes == 4 && IndexBytes == 8) {
+                // 4个64位下标 -> 4个32位元素
+                for (; k + 4 <= n; k += 4) {
+                    auto vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k * 8));
+                    auto v = _mm256_i64gather_epi32(static_cast<const int*>(base), vi, 4);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k * 4), v);
+                }
+            }
+            else if constexpr (ValueBytes == 8 && IndexBytes == 4) {
+                // 4个32位下标 -> 4个64位元素
+                for (; k + 4 <= n; k += 4) {
+                    auto vi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + k * 4));
+                    auto v = _mm256_i32gather_epi64(static_cast<const long long*>(base), vi, 8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k * 8), v);
+                }
+            }
+            else {
+                // 4个64位下标 -> 4个64位元素
+                for (; k + 4 <= n; k += 4) {
+                    auto vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k * 8));
+                    auto v = _mm256_i64gather_epi64(static_cast<const long long*>(base), vi, 8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k * 8), v);
+                }
+            }
+            return k;
+        }
+    }
+    #pragma GCC pop_options
+#endif
+
+
+    // 二、编译期按容器、下标、输出迭代器的形态分类
+    namespace Detail
+    {
+        template<typename Container, typename Indices>
+        using ElementRef = decltype(std::declval<Container>()[*std::ranges::begin(std::declval<const Indices&>())]);
+
+        // 元素按位搬运即可：算术类型（不含bool），4或8字节
+        template<typename T>
+        constexpr bool GatherableValue = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+                                      && (sizeof(T) == 4 || sizeof(T) == 8);
+
+        template<typename T>
+        constexpr bool GatherableIndex = std::is_integral_v<T> && !std::is_same_v<T, bool>
+                                      && (sizeof(T) == 4 || sizeof(T) == 8);
+
+        template<typename Container, typename Indices, typename Out>
+        constexpr bool canGather()
+        {
+            using C = std::remove_reference_t<Container>;
+            if constexpr (!EMCP_FIXED_SEARCH_SIMD
+                          || !std::ranges::contiguous_range<C> || !std::ranges::contiguous_range<const Indices>
+                          || !std::contiguous_iterator<Out>) {
+                return false;
+            }
+            else {
+                using T = std::ranges::range_value_t<C>;
+                using I = std::ranges::range_value_t<const Indices>;
+                return GatherableValue<T> && GatherableIndex<I>
+                    && std::is_same_v<std::iter_value_t<Out>, T>
+                    && std::is_same_v<std::iter_reference_t<Out>, T&>;
+            }
+        }
+
+        // 只对随机访问容器预取，且要能对元素取地址（operator[]返回真正的左值引用）
+        // std::map的operator[]也返回左值引用，但提前求值c[idx[k + PrefetchDistance]]会提前插入缺失的键
+        template<typename Container, typename Indices>
+        constexpr bool canPrefetch()
+        {
+            if constexpr (!std::ranges::random_access_range<std::remove_reference_t<Container>>
+                          || !std::ranges::random_access_range<const Indices> || !std::ranges::sized_range<const Indices>) {
+                return false;
+            }
+            else {
+                return std::is_lvalue_reference_v<ElementRef<Container, Indices>>;
+            }
+        }
+
+        template<typename Container, typename IndexIt, typename Out>
+        Out scalar(Container&& c, IndexIt first, IndexIt last, Out out)
+        {
+            for (; first != last; ++first, ++out) {
+                *out = std::forward<Container>(c)[*first];
+            }
+            return out;
+        }
+
+        template<typename Container, typename Indices, typename Out>
+        Out prefetched(Container&& c, const Indices& indices, Out out)
+        {
+            auto idx = std::ranges::begin(indices);
+            const auto n = static_cast<std::size_t>(std::ranges::size(indices));
+
+            // 主循环：取第k个元素时预取第k + PrefetchDistance个；最后PrefetchDistance个不再预取
+            std::size_t k = 0;
+            for (; k + PrefetchDistance < n; ++k, ++out) {
+                prefetch(std::addressof(c[idx[k + PrefetchDistance]]));
+                *out = std::forward<Container>(c)[idx[k]];
+            }
+            return scalar(std::forward<Container>(c), idx + k, idx + n, out);
+        }
+    }
+
+
+    // 三、对外接口
+    template<typename Container, typename Indices, typename Out>
+        requires std::ranges::input_range<const Indices>
+    Out getValues(Container&& c, const Indices& indices, Out out)
+    {
+#if EMCP_FIXED_SEARCH_SIMD
+        if constexpr (Detail::canGather<Container, Indices, Out>()) {
+            using T = std::ranges::range_value_t<std::remove_reference_t<Container>>;
+            using I = std::ranges::range_value_t<const Indices>;
+
+            const auto n = static_cast<std::size_t>(std::ranges::size(indices));
+            const bool indexFits = sizeof(I) == 8
+                || std::ranges::size(c) <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+            if (indexFits && Item01_FixedSearch::hasAvx2()) {
+                const I* idx = std::ranges::data(indices);
+                T* dst = std::to_address(out);
+                std::size_t done = Avx2::gather<sizeof(T), sizeof(I)>(std::ranges::data(c), idx, dst, n);
+                out += static_cast<std::iter_difference_t<Out>>(done);
+                return Detail::scalar(std::forward<Container>(c), idx + done, idx + n, out);
+            }
+        }
+#endif
+        if constexpr (Detail::canPrefetch<Container, Indices>()) {
+            return Detail::prefetched(std::forward<Container>(c), indices, out);
+        }
+        else {
+            return Detail::scalar(std::forward<Container>(c), std::ranges::begin(indices), std::ranges::end(indices), out);
+        }
+    }
+
+    // 便捷版本：结果放进一个新的std::vector
+    template<typename Container, typename Indices>
+        requires std::ranges::input_range<const Indices> && std::ranges::range<Container>
+    auto getValues(Container&& c, const Indices& indices)
+    {
+        std::vector<std::ranges::range_value_t<std::remove_reference_t<Container>>> result;
+        if constexpr (std::ranges::sized_range<const Indices>) {
+            result.resize(std::ranges::size(indices));
+            getValues(std::forward<Container>(c), indices, result.begin());
+        }
+        else {
+            getValues(std::forward<Container>(c), indices, std::back_inserter(result));
+        }
+        return result;
+    }
+
+    inline void test()
+    {
+        std::vector<int> v{ 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+        std::deque<double> d{ 0.5, 1.5, 2.5, 3.5, 4.5 };
+        std::vector<std::uint32_t> indices{ 9, 0, 3, 3, 7, 1, 2, 8, 5 };
+
+        int gathered[9];
+        getValues(v, indices, gathered);                // AVX2 gather：前8个一条指令，最后1个标量
+
+        auto fromDeque = getValues(d, std::vector<std::size_t>{ 4, 0, 2 });    // 预取路径
+
+        std::vector<bool> flags{ true, false, true };
+        auto picked = getValues(flags, std::vector<int>{ 2, 1 });              // 代理引用，逐个取值
+    }
+}
+
+// 总结
+// * 批量接口让实现能看到"接下来要访问哪些位置"：连续容器可以一次gather多个元素，分段容器可以提前预取
+// * 标量路径沿用 std::forward<Container>(c)[i]，保持decltype(auto)推导出的元素类型
@@ -0,0 +1,137 @@
+/* 条款3 扩展 - 右值容器的消费式取值：take / drain */
+
+#pragma once
+
+#include <deque>
+#include <iterator>
+#include <map>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item03.hpp中的DecltypeDeductions5::getValue：
+
+        template<typename Container, typename Index>
+        decltype(auto) getValue(Container&& c, Index i)
+        {
+            return std::forward<Container>(c)[i];
+        }
+
+        getValue((std::deque<int>{ 1, 2, 3, 4, 5 }), 2) = 10;
+
+    万有引用让右值容器也能传进来，但std::deque的operator[]没有按引用限定符区分左右值，
+    返回的仍然是int& —— 一个指向临时容器内部的引用，语句结束后就悬空了。
+    同时，既然容器马上要销毁，元素本可以直接移动出来，却只能拷贝：
+        std::string s = getValue(makeNames(), 2);       // 拷贝一次字符串，随后临时容器整个销毁
+
+    这里提供一组只接受右值容器的"消费式"接口：
+    * take(std::move(c), i)                按值返回元素，元素从容器中移动出来
+    * drain(std::move(c), pred, sink)      把满足pred的元素逐个移动给sink，最后清空容器
+        sink可以是可调用对象 sink(std::move(e))，也可以是输出迭代器 *sink++ = std::move(e)
+        返回值与std::for_each/std::copy一致：返回（更新后的）sink
+    传入左值会在编译期报错，避免在调用者不知情的情况下掏空一个还要继续使用的容器。
+*/
+
+namespace Item03_Take
+{
+    namespace Detail
+    {
+        // 元素类型：关联容器取mapped_type（map的operator[]返回它），其余取range_value_t
+        template<typename C>
+        struct Element
+        {
+            using type = std::ranges::range_value_t<C>;
+        };
+
+        template<typename C>
+            requires requires { typename C::mapped_type; }
+        struct Element<C>
+        {
+            using type = typename C::mapped_type;
+        };
+
+        template<typename C>
+        using ElementT = typename Element<std::remove_cvref_t<C>>::type;
+
+        template<typename C>
+        concept Consumable = !std::is_lvalue_reference_v<C> && !std::is_const_v<std::remove_reference_t<C>>;
+
+        template<typename Sink, typename T>
+        void put(Sink& sink, T&& value)
+        {
+            if constexpr (std::is_invocable_v<Sink&, T&&>) {
+                sink(std::forward<T>(value));
+            }
+            else {
+                *sink = std::forward<T>(value);
+                ++sink;
+            }
+        }
+    }
+
+    // 按值返回第i个元素，元素被移动出来
+    // 对std::vector<bool>这类代理引用，移动代理等价于取出bool值
+    template<typename Container, typename Index>
+        requires Detail::Consumable<Container>
+    Detail::ElementT<Container> take(Container&& c, Index i)
+    {
+        return Detail::ElementT<Container>(std::move(c[i]));
+    }
+
+    template<typename Container, typename Index>
+        requires (!Detail::Consumable<Container>)
+    void take(Container&& c, Index i) = delete;         // 左值或const容器：请用getValue，或显式std::move
+
+    // 把满足pred的元素依次移动给sink，然后清空容器
+    // pred只看到const引用，不能在判断时修改元素
+    template<typename Container, typename Pred, typename Sink>
+        requires Detail::Consumable<Container> && std::ranges::range<Container>
+    Sink drain(Container&& c, Pred pred, Sink sink)
+    {
+        for (auto& e : c) {
+            if (pred(std::as_const(e))) Detail::put(sink, std::move(e));
+        }
+        if constexpr (requires { c.clear(); }) {
+            c.clear();                                  // 剩下的都是移动后的对象，清空后状态明确
+        }
+        return sink;
+    }
+
+    template<typename Container, typename Pred, typename Sink>
+        requires (!Detail::Consumable<Container>)
+    Sink drain(Container&& c, Pred pred, Sink sink) = delete;
+
+    inline void test()
+    {
+        auto makeNames = [] { return std::vector<std::string>{ std::string(32, 'a'), std::string(32, 'b'), "c" }; };
+
+        // 按值返回，没有悬空引用，字符串被移动出来而不是拷贝
+        std::string b = take(makeNames(), 1);
+
+        std::deque<int> d{ 1, 2, 3, 4, 5 };
+        int third = take(std::move(d), 2);
+
+        std::map<int, std::vector<int>> groups{ { 1, { 1, 2, 3 } }, { 2, { 4, 5 } } };
+        std::vector<int> group = take(std::move(groups), 1);
+
+        // 长字符串移动进另一个vector；drain之后names为空
+        std::vector<std::string> names = makeNames();
+        std::vector<std::string> longNames;
+        drain(std::move(names), [](const std::string& s) { return s.size() > 16; }, std::back_inserter(longNames));
+
+        // sink也可以是可调用对象
+        std::size_t total = 0;
+        drain(makeNames(), [](const std::string&) { return true; }, [&](std::string&& s) { total += s.size(); });
+
+        // take(names, 0);                              // 编译错误：左值容器
+
+        (void)third;
+    }
+}
+
+// 总结
+// * 右值容器的operator[]通常仍然返回左值引用，decltype(auto)会把这个指向临时对象的引用原样返回
+// * 容器即将销毁时，按值返回并移动元素，既避免悬空引用，也省掉一次拷贝
@@ -1,7 +1,9 @@
 /* 条款4 - 掌握查看类别推导结果的方法 */
 
-#include <iostream>
-#include <typeinfo>
+#include "item04_fast_sink.hpp"
+#include "item04_trace.hpp"
+#include "item04_type_name.hpp"
+
 #include <vector>
 /*
     掌握查看类型推导结果的方法
@@ -18,6 +20,8 @@ class TD;
 
 void test()
 {
+    TRACE_SCOPE("item04_1::test");
+
     const int theAnaswer = 42;
 
     auto x = theAnaswer;
@@ -32,14 +36,20 @@ void test()
 
 // 运行时
 // typeid可以返回类型信息，但每家编译器实现不一样，且不准确
+// 这里改用编译期的type_name（item04_type_name.hpp），保留了typeid丢掉的const和引用
 namespace item04_2
 {
 
 template<typename T>
 void f(const T& param)
 {
-    std::cout << "T = " << typeid(T).name() << std::endl;
-    std::cout << "ParamType = " << typeid(param).name() << std::endl;
+    TRACE_SCOPE("item04_2::f");
+
+    // typeid(T).name()              GCC: PN8item04_26WidgetE
+    // typeid(param).name()          GCC: PN8item04_26WidgetE（const T&中的const和&都丢了）
+    // std::cout << ... << std::endl 每行都会flush；fast_sink在程序退出时一次写出
+    Item04_FastSink::out().print("T = {}\n", Item04_TypeName::type_name<T>());
+    Item04_FastSink::out().print("ParamType = {}\n", Item04_TypeName::type_name<decltype(param)>());
 }
 
 class Widget
@@ -48,6 +58,8 @@ class Widget
 
 void test()
 {
+    TRACE_SCOPE("item04_2::test");
+
     std::vector<Widget> createVec(2);
 
     f(&createVec[0]);
@@ -58,6 +70,7 @@ void test()
 
 int main()
 {
+    TRACE_SCOPE("main");
 
     item04_2::test();
 
@@ -0,0 +1,332 @@
+/* 条款4 扩展 - 不分配、不逐行刷新的格式化输出：fast_sink */
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <cerrno>
+    #include <unistd.h>
+#endif
+
+/*
+    item04.cpp中的item04_2::f用 std::cout << ... << std::endl 输出类型名。
+    用来打印两行没有问题，但在日志、大量数据导出这样的热路径上：
+    * std::endl每一行都flush一次，即每行一次write系统调用
+    * 每个 << 都要经过虚函数、locale、sentry，浮点数格式化还可能分配内存
+    * basic_ios本身很重，而且被故意设计成不可拷贝（条款11：item11.cpp中basic_ios的拷贝操作被delete）
+
+    fast_sink是一个直接面向文件描述符的缓冲写入器：
+    * 整数、浮点数用std::to_chars直接写进缓冲区，不经过locale，不分配内存
+    * 缓冲区是对象内的定长数组（64KB），写满或调用flush()、析构时才一次性write出去
+    * print("x = {}, y = {:.3}\n", x, y) 使用fmt风格的格式串，并在编译期检查：
+        占位符个数与实参个数一致、格式说明与实参类型匹配、花括号成对
+      支持的格式说明：
+        {}      任意支持的类型
+        {:x}    整数，十六进制
+        {:.N}   浮点数，保留N位小数（N为1~2位数字）
+        {{ }}   输出花括号本身
+    * out()返回绑定到标准输出（fd 1）的thread_local实例，各线程各自缓冲，互不加锁
+
+    与std::cout混用同一个文件描述符时，两边的缓冲区各自刷新，输出顺序不保证。
+*/
+
+namespace Item04_FastSink
+{
+    // 一、编译期检查的格式串
+    namespace Detail
+    {
+        enum class Kind : unsigned char { Integer, Floating, Bool, Char, String, Pointer, None };
+
+        template<typename T>
+        constexpr Kind kindOf() noexcept
+        {
+            using U = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<U, bool>) return Kind::Bool;
+            else if constexpr (std::is_same_v<U, char>) return Kind::Char;
+            else if constexpr (std::is_integral_v<U>) return Kind::Integer;
+            else if constexpr (std::is_floating_point_v<U>) return Kind::Floating;
+            else if constexpr (std::is_convertible_v<const U&, std::string_view>) return Kind::String;
+            else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) return Kind::Pointer;
+            else return Kind::None;
+        }
+
+        template<typename T>
+        concept Formattable = kindOf<T>() != Kind::None;
+
+        // 格式串出错时，常量求值会在这里失败，编译器的报错中会带上这个函数名
+        inline void format_string_error(const char*) {}
+
+        struct Spec
+        {
+            bool hex = false;
+            int precision = -1;         // <0：最短往返表示
+        };
+
+        // 解析一个占位符：fmt[i]为'{'，返回'}'之后的位置
+        constexpr std::size_t parseSpec(std::string_view fmt, std::size_t i, Spec& spec)
+        {
+            ++i;
+            if (i < fmt.size() && fmt[i] == ':') {
+                ++i;
+                if (i < fmt.size() && fmt[i] == 'x') {
+                    spec.hex = true;
+                    ++i;
+                }
+                else if (i < fmt.size() && fmt[i] == '.') {
+                    ++i;
+                    int digits = 0;
+                    spec.precision = 0;
+                    while (i < fmt.size() && fmt[i] >= '0' && fmt[i] <= '9' && digits < 2) {
+                        spec.precision = spec.precision * 10 + (fmt[i] - '0');
+                        ++i;
+                        ++digits;
+                    }
+                    if (digits == 0) format_string_error("'.'后面需要精度数字");
+                }
+                else {
+                    format_string_error("不支持的格式说明");
+                }
+            }
+            if (i >= fmt.size() || fmt[i] != '}') format_string_error("占位符缺少'}'，或格式说明不支持");
+            return i + 1;
+        }
+    }
+
+    template<typename... Args>
+    class basic_format_string
+    {
+    public:
+        template<typename S>
+            requires std::is_convertible_v<const S&, std::string_view>
+        consteval basic_format_string(const S& s) : str(s)
+        {
+            constexpr Detail::Kind kinds[] = { Detail::kindOf<Args>()..., Detail::Kind::None };
+            std::size_t arg = 0;
+
+            for (std::size_t i = 0; i < str.size();) {
+                if (str[i] == '{') {
+                    if (i + 1 < str.size() && str[i + 1] == '{') { i += 2; continue; }
+
+                    Detail::Spec spec;
+                    i = Detail::parseSpec(str, i, spec);
+                    if (arg >= sizeof...(Args)) Detail::format_string_error("占位符多于实参");
+                    if (spec.hex && kinds[arg] != Detail::Kind::Integer) Detail::format_string_error("{:x}只能用于整数");
+                    if (spec.precision >= 0 && kinds[arg] != Detail::Kind::Floating) Detail::format_string_error("{:.N}只能用于浮点数");
+                    ++arg;
+                }
+                else if (str[i] == '}') {
+                    if (i + 1 < str.size() && str[i + 1] == '}') { i += 2; continue; }
+                    Detail::format_string_error("单独的'}'，应写作'}}'");
+                }
+                else {
+                    ++i;
+                }
+            }
+            if (arg != sizeof...(Args)) Detail::format_string_error("实参多于占位符");
+        }
+
+        constexpr std::string_view get() const noexcept { return str; }
+
+    private:
+        std::string_view str;
+    };
+
+    // type_identity：格式串不参与Args的推导，Args只由实参决定
+    template<typename... Args>
+    using format_string = basic_format_string<std::type_identity_t<Args>...>;
+
+
+    // 二、写入器
+    class fast_sink
+    {
+    public:
+        static constexpr std::size_t Capacity = 64 * 1024;
+
+        explicit fast_sink(int fd) noexcept : fd(fd) {}
+        ~fast_sink() { flush(); }
+
+        // 与basic_ios一样不可拷贝：两个对象共享同一段未刷新的输出没有意义
+        fast_sink(const fast_sink&) = delete;
+        fast_sink& operator=(const fast_sink&) = delete;
+
+        template<Detail::Formattable... Args>
+        void print(format_string<Args...> fmt, const Args&... args)
+        {
+            format(fmt.get(), args...);
+        }
+
+        void write(std::string_view text) noexcept
+        {
+            if (text.size() > Capacity - used) {
+                flush();
+                if (text.size() > Capacity) {
+                    writeAll(text.data(), text.size());        // 比整个缓冲区还大：直接写出
+                    return;
+                }
+            }
+            std::memcpy(buffer + used, text.data(), text.size());
+            used += text.size();
+        }
+
+        void put(char c) noexcept
+        {
+            if (used == Capacity) flush();
+            buffer[used++] = c;
+        }
+
+        void flush() noexcept
+        {
+            writeAll(buffer, used);
+            used = 0;
+        }
+
+        // 曾经有写入失败（磁盘满、管道关闭……）时为false，失败的数据被丢弃
+        bool good() const noexcept { return !failed; }
+
+    private:
+        // 先按格式串的字面部分原样输出，遇到占位符时格式化第一个实参，再处理剩余部分
+        void format(std::string_view fmt)
+        {
+            writeLiteral(fmt);
+        }
+
+        template<typename First, typename... Rest>
+        void format(std::string_view fmt, const First& first, const Rest&... rest)
+        {
+            std::size_t i = 0;
+            for (;;) {
+                const std::size_t brace = fmt.find_first_of("{}", i);
+                writeLiteral(fmt.substr(i, brace - i));
+                if (fmt[brace] == fmt[brace + 1]) {             // "{{" 或 "}}"
+                    put(fmt[brace]);
+                    i = brace + 2;
+                    continue;
+                }
+
+                Detail::Spec spec;
+                i = Detail::parseSpec(fmt, brace, spec);
+                formatArg(first, spec);
+                format(fmt.substr(i), rest...);
+                return;
+            }
+        }
+
+        // 字面部分已经过编译期检查，只剩成对的花括号需要还原
+        void writeLiteral(std::string_view text) noexcept
+        {
+            for (std::size_t i = 0; i < text.size();) {
+                const std::size_t brace = text.find_first_of("{}", i);
+                if (brace == std::string_view::npos) {
+                    write(text.substr(i));
+                    return;
+                }
+                write(text.substr(i, brace + 1 - i));
+                i = brace + 2;
+            }
+        }
+
+        template<typename T>
+        void formatArg(const T& value, Detail::Spec spec)
+        {
+            constexpr Detail::Kind kind = Detail::kindOf<T>();
+            if constexpr (kind == Detail::Kind::Integer) {
+                toChars([&](char* first, char* last) { return std::to_chars(first, last, value, spec.hex ? 16 : 10); });
+            }
+            else if constexpr (kind == Detail::Kind::Floating) {
+                if (spec.precision >= 0) {
+                    toChars([&](char* first, char* last) {
+                        return std::to_chars(first, last, value, std::chars_format::fixed, spec.precision);
+                    });
+                }
+                else {
+                    toChars([&](char* first, char* last) { return std::to_chars(first, last, value); });
+                }
+            }
+            else if constexpr (kind == Detail::Kind::Bool) {
+                write(value ? "true" : "false");
+            }
+            else if constexpr (kind == Detail::Kind::Char) {
+                put(value);
+            }
+            else if constexpr (kind == Detail::Kind::String) {
+                write(std::string_view(value));
+            }
+            else {
+                write("0x");
+                toChars([&](char* first, char* last) {
+                    return std::to_chars(first, last, reinterpret_cast<std::uintptr_t>(value), 16);
+                });
+            }
+        }
+
+        // 先在剩余空间中格式化，放不下就刷新后重试；64KB足以容纳任何一个数字
+        template<typename F>
+        void toChars(F convert) noexcept
+        {
+            auto result = convert(buffer + used, buffer + Capacity);
+            if (result.ec == std::errc::value_too_large) {
+                flush();
+                result = convert(buffer, buffer + Capacity);
+            }
+            if (result.ec == std::errc()) used = static_cast<std::size_t>(result.ptr - buffer);
+        }
+
+        void writeAll(const char* data, std::size_t size) noexcept
+        {
+            while (size > 0 && !failed) {
+#if defined(_WIN32)
+                const int n = ::_write(fd, data, static_cast<unsigned>(size));
+#else
+                const auto n = ::write(fd, data, size);
+                if (n < 0 && errno == EINTR) continue;
+#endif
+                if (n <= 0) {
+                    failed = true;
+                    return;
+                }
+                data += n;
+                size -= static_cast<std::size_t>(n);
+            }
+        }
+
+        int fd;
+        bool failed = false;
+        std::size_t used = 0;
+        char buffer[Capacity];
+    };
+
+    // 标准输出：每个线程一个实例，线程结束（主线程为程序退出）时刷新
+    inline fast_sink& out()
+    {
+        thread_local fast_sink sink(1);
+        return sink;
+    }
+
+    inline void test()
+    {
+        fast_sink& sink = out();
+
+        sink.print("{} + {} = {}\n", 1, 2, 1 + 2);
+        sink.print("pi = {:.3}, hex = {:x}, {}\n", 3.14159, 255u, true);
+        sink.print("{{literal}} {}\n", std::string_view("text"));
+
+        // sink.print("{} {}\n", 1);                     // 编译错误：占位符多于实参
+        // sink.print("{:x}\n", 1.5);                    // 编译错误：{:x}只能用于整数
+        sink.flush();
+    }
+}
+
+// 总结
+// * std::endl = '\n' + flush；大量输出时用'\n'，把刷新留给缓冲区
+// * std::to_chars不依赖locale、不分配内存，是最快的数字格式化方式
+// * 格式串在编译期检查，运行时只剩按位置填充
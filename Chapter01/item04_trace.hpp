@@ -0,0 +1,283 @@
+/* 条款4 扩展 - 运行时查看程序"做了什么"：TRACE_SCOPE与Chrome trace导出 */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+/*
+    条款4讲的是如何查看类型推导的结果（IDE、编译器报错、typeid）。
+    这里把同样的思路用在运行时行为上：在作用域入口放一个TRACE_SCOPE，就能在时间线上看到它何时开始、持续多久。
+
+        void test()
+        {
+            TRACE_SCOPE("item04_2::test");
+            ...
+        }
+
+    * 作用域进入和退出时各读一次时钟（x86上为rdtsc，其余平台为steady_clock）
+    * 退出时把 { name, begin, end } 写进当前线程自己的环形缓冲区：不加锁，不分配，不与其它线程共享缓存行
+      缓冲区写满后覆盖最旧的事件
+    * 程序退出时（或手动调用flush()）把所有线程缓冲区中的事件写成Chrome trace-event JSON，
+      用 chrome://tracing 或 https://ui.perfetto.dev 打开
+      输出文件默认为 emcp_trace.json，可由环境变量EMCP_TRACE_FILE或setOutput()修改
+    * 编译时未定义EMCP_TRACE（或定义为0）时，TRACE_SCOPE展开为空语句，没有任何开销
+
+    name必须是字符串字面量：缓冲区中只保存指针，导出时才读取内容。
+*/
+
+#ifndef EMCP_TRACE
+    #define EMCP_TRACE 0
+#endif
+
+namespace Item04_Trace
+{
+    // 每个线程最多保留的事件数，必须是2的幂
+    inline constexpr std::size_t RingCapacity = std::size_t(1) << 14;
+
+    // 一、时钟
+    inline std::uint64_t now() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // 二、每线程环形缓冲区（单写者）
+    // 导出可能与写入同时发生：写者先公开reserved，再写事件，最后公开head；
+    // 读者复制完事件后再看reserved，凡是可能已被覆盖的槽位都丢弃。
+    // 事件字段用relaxed原子量，在x86上与普通读写相同。
+    struct Event
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<std::uint64_t> begin{ 0 };
+        std::atomic<std::uint64_t> end{ 0 };
+    };
+
+    struct Snapshot
+    {
+        const char* name;
+        std::uint64_t begin;
+        std::uint64_t end;
+    };
+
+    class alignas(64) ThreadBuffer
+    {
+    public:
+        explicit ThreadBuffer(std::uint32_t tid) : tid(tid), events(new Event[RingCapacity]) {}
+
+        void push(const char* name, std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            const std::uint64_t h = head.load(std::memory_order_relaxed);
+            reserved.store(h + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            Event& e = events[h & (RingCapacity - 1)];
+            e.name.store(name, std::memory_order_relaxed);
+            e.begin.store(begin, std::memory_order_relaxed);
+            e.end.store(end, std::memory_order_relaxed);
+
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        // 复制出仍然有效的事件（最多RingCapacity个）
+        std::vector<Snapshot> snapshot() const
+        {
+            const std::uint64_t h = head.load(std::memory_order_acquire);
+            const std::uint64_t first = h > RingCapacity ? h - RingCapacity : 0;
+
+            std::vector<Snapshot> copied;
+            copied.reserve(static_cast<std::size_t>(h - first));
+            for (std::uint64_t i = first; i < h; ++i) {
+                const Event& e = events[i & (RingCapacity - 1)];
+                copied.push_back({ e.name.load(std::memory_order_relaxed),
+                                   e.begin.load(std::memory_order_relaxed),
+                                   e.end.load(std::memory_order_relaxed) });
+            }
+
+            // 复制期间写者又写了r - h个事件，它们覆盖了下标小于 r - RingCapacity 的槽位
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const std::uint64_t r = reserved.load(std::memory_order_relaxed);
+            const std::uint64_t valid = r > RingCapacity ? r - RingCapacity : 0;
+            if (valid > first) {
+                const auto drop = static_cast<std::size_t>(std::min<std::uint64_t>(valid - first, copied.size()));
+                copied.erase(copied.begin(), copied.begin() + static_cast<std::ptrdiff_t>(drop));
+            }
+            return copied;
+        }
+
+        const std::uint32_t tid;
+
+    private:
+        std::atomic<std::uint64_t> head{ 0 };
+        std::atomic<std::uint64_t> reserved{ 0 };
+        std::unique_ptr<Event[]> events;
+    };
+
+    // 三、会话：登记所有线程的缓冲区，负责时钟换算和导出
+    // 缓冲区归会话所有，线程退出后事件仍然保留到导出为止
+    class Session
+    {
+    public:
+        // 不析构：各线程缓存了指向缓冲区的指针，静态对象的析构函数、分离的线程在退出阶段仍可能写入。
+        // 导出由atexit完成，此后结束的作用域照常写入缓冲区，只是不再输出
+        static Session& instance()
+        {
+            static Session* session = [] {
+                auto* s = new Session;
+                std::atexit([] { instance().flush(); });
+                return s;
+            }();
+            return *session;
+        }
+
+        ThreadBuffer* registerThread()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<std::uint32_t>(buffers.size() + 1)));
+            return buffers.back().get();
+        }
+
+        // path为nullptr时不输出文件
+        void setOutput(const char* path)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            output = path ? path : "";
+        }
+
+        // 把当前所有缓冲区中的事件写成一个完整的JSON文件（覆盖已有文件）
+        void flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (output.empty()) return;
+
+            std::FILE* file = std::fopen(output.c_str(), "w");
+            if (!file) return;
+
+            // 以会话创建和最早的事件中较早者为时间零点
+            std::vector<std::vector<Snapshot>> snapshots;
+            std::uint64_t base = startTicks;
+            for (const auto& buffer : buffers) {
+                snapshots.push_back(buffer->snapshot());
+                for (const Snapshot& e : snapshots.back()) base = std::min(base, e.begin);
+            }
+
+            bool first = true;
+            std::fputs("{\"traceEvents\":[\n", file);
+            for (std::size_t b = 0; b < buffers.size(); ++b) {
+                for (const Snapshot& e : snapshots[b]) {
+                    std::fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+                    writeEscaped(file, e.name);
+                    std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                 buffers[b]->tid,
+                                 static_cast<double>(e.begin - base) / ticksPerMicro,
+                                 static_cast<double>(e.end - e.begin) / ticksPerMicro);
+                    first = false;
+                }
+            }
+            std::fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+            std::fclose(file);
+        }
+
+    private:
+        Session() : ticksPerMicro(ticksPerMicrosecond()), startTicks(now())
+        {
+            const char* path = std::getenv("EMCP_TRACE_FILE");
+            output = path ? path : "emcp_trace.json";
+        }
+
+        // rdtsc的频率未知：创建会话时对照steady_clock测量一个固定的窗口（约2ms，只发生一次），
+        // 而不是用程序实际运行的时长，后者在很短的程序中只有几微秒
+        static double ticksPerMicrosecond()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            using Clock = std::chrono::steady_clock;
+            const Clock::time_point t0 = Clock::now();
+            const std::uint64_t c0 = now();
+            Clock::time_point t1;
+            do {
+                t1 = Clock::now();
+            } while (t1 - t0 < std::chrono::milliseconds(2));
+            const std::uint64_t c1 = now();
+
+            const double micros = std::chrono::duration<double, std::micro>(t1 - t0).count();
+            const double ticks = static_cast<double>(c1 - c0);
+            return micros > 0 && ticks > 0 ? ticks / micros : 1.0;
+#else
+            // now()就是steady_clock的计数，频率已知
+            using Period = std::chrono::steady_clock::period;
+            return static_cast<double>(Period::den) / (static_cast<double>(Period::num) * 1e6);
+#endif
+        }
+
+        static void writeEscaped(std::FILE* file, const char* s)
+        {
+            for (; s && *s; ++s) {
+                if (*s == '"' || *s == '\\') std::fputc('\\', file);
+                std::fputc(*s, file);
+            }
+        }
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::string output;
+        const double ticksPerMicro;
+        const std::uint64_t startTicks;         // 在校准之后读取，校准的时间不出现在时间线上
+    };
+
+    inline ThreadBuffer& localBuffer()
+    {
+        thread_local ThreadBuffer* buffer = Session::instance().registerThread();
+        return *buffer;
+    }
+
+    inline void setOutput(const char* path) { Session::instance().setOutput(path); }
+    inline void flush() { Session::instance().flush(); }
+
+    // 四、作用域对象
+    class Scope
+    {
+    public:
+        // 进入时取缓冲区：第一次调用会创建会话并校准时钟，这段时间不计入任何作用域
+        explicit Scope(const char* name) : buffer(localBuffer()), name(name), begin(now()) {}
+        ~Scope() { buffer.push(name, begin, now()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ThreadBuffer& buffer;
+        const char* name;
+        std::uint64_t begin;
+    };
+}
+
+#define EMCP_TRACE_CONCAT_IMPL(a, b) a##b
+#define EMCP_TRACE_CONCAT(a, b) EMCP_TRACE_CONCAT_IMPL(a, b)
+
+#if EMCP_TRACE
+    // "" name 保证name是字符串字面量
+    #define TRACE_SCOPE(name) ::Item04_Trace::Scope EMCP_TRACE_CONCAT(emcpTraceScope, __LINE__)("" name)
+#else
+    #define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+// 总结
+// * 每个作用域两次时钟读取、一次写本线程的缓冲区，没有锁和分配，开销在几十个时钟周期以内
+// * 事件先留在内存里，退出时再统一格式化输出，I/O不出现在被测代码的路径上
+// * 关闭EMCP_TRACE时宏展开为空，发布版本零开销
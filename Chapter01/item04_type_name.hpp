@@ -0,0 +1,85 @@
+/* 条款4 扩展 - 编译期类型名：type_name<T>() */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/*
+    item04.cpp中的item04_2::f用typeid(T).name()在运行时查看类型，有两个问题：
+    * 按值语义比较类型：const、volatile、引用全部被丢掉（条款4：std::type_info::name的结果"不准确"）
+    * GCC/Clang给出的是修饰名（如 PN8item04_26WidgetE），要可读还得调用abi::__cxa_demangle，
+      它每次都要解析一遍字符串，并用malloc分配结果
+
+    编译器本身知道模板实参的完整名字，并把它写进了__PRETTY_FUNCTION__（MSVC为__FUNCSIG__）：
+        GCC:   constexpr const char* Item04_TypeName::Detail::rawName() [with T = const int&]
+        Clang: const char *Item04_TypeName::Detail::rawName() [T = const int &]
+        MSVC:  const char *__cdecl Item04_TypeName::Detail::rawName<const int&>(void)
+    用一个已知类型（double）探测出类型名前后各有多少个字符，就能在编译期截取出任意T的名字。
+
+    截取结果复制进一个只有类型名那么长的静态数组，type_name<T>()只返回指向它的string_view：
+    运行时没有任何计算和分配，可执行文件中也只留下类型名本身，而不是整个函数签名。
+
+    不同编译器的拼写不同（const int& / const int &），只适合显示，不要用来比较或序列化。
+*/
+
+namespace Item04_TypeName
+{
+    namespace Detail
+    {
+        template<typename T>
+        constexpr const char* rawName() noexcept
+        {
+#if defined(__clang__) || defined(__GNUC__)
+            return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+    #error "type_name<T>() 需要 __PRETTY_FUNCTION__ 或 __FUNCSIG__"
+#endif
+        }
+
+        // 探测：double在签名中出现的位置就是类型名的起点，其后剩下的字符数就是固定后缀的长度
+        inline constexpr std::string_view probe = rawName<double>();
+        inline constexpr std::size_t prefixLength = probe.find("double");
+        inline constexpr std::size_t suffixLength = probe.size() - prefixLength - std::string_view("double").size();
+
+        static_assert(prefixLength != std::string_view::npos, "无法从函数签名中定位类型名");
+
+        template<typename T>
+        constexpr auto makeName() noexcept
+        {
+            constexpr std::string_view raw = rawName<T>();
+            constexpr std::string_view name = raw.substr(prefixLength, raw.size() - prefixLength - suffixLength);
+
+            std::array<char, name.size() + 1> storage{};        // 末尾留一个'\0'，方便传给C接口
+            for (std::size_t i = 0; i < name.size(); ++i) storage[i] = name[i];
+            return storage;
+        }
+
+        template<typename T>
+        inline constexpr auto nameStorage = makeName<T>();
+    }
+
+    // 保留cv限定和引用：type_name<const int&>() == "const int&"（GCC）
+    template<typename T>
+    constexpr std::string_view type_name() noexcept
+    {
+        return { Detail::nameStorage<T>.data(), Detail::nameStorage<T>.size() - 1 };
+    }
+
+    inline void test()
+    {
+        static_assert(type_name<int>() == "int");
+        static_assert(type_name<double>() == "double");
+
+        constexpr auto constRef = type_name<const int&>();   // GCC: const int&    Clang: const int &
+                                                             // 而 typeid(const int&) == typeid(int)
+        (void)constRef;
+    }
+}
+
+// 总结
+// * typeid(T).name()会丢掉cv限定和引用，且名字是否可读由实现决定
+// * 利用__PRETTY_FUNCTION__可以在编译期得到完整的类型名，运行时零开销
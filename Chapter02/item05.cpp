@@ -31,6 +31,8 @@ namespace
         }
     }
 
+    // 补全后的版本（执行策略、连续迭代器向量化、线程池切分）见item05_dwim.hpp
+
 }
 
 
@@ -0,0 +1,334 @@
+/* 条款5 扩展 - 让dwim真正"做事"：按执行策略并行的变换算法 */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item05.cpp中的dwim只演示了auto如何推导 *b 的类型：
+
+        template<typename It>
+        void dwim(It b, It e)
+        {
+            while (b != e) {
+                auto currValue = *b;
+                // …
+            }
+        }
+
+    这里把它补全成一个"对区间内每个元素做变换"的算法：
+        dwim(policy, b, e, op)              原地变换：*it = op(*it)
+        dwim(policy, b, e, out, op)         写到另一个区间：*out++ = op(*it)，返回out的末尾（同std::transform）
+
+    执行策略（仿照std::execution，但不依赖TBB）：
+        seq                 当前线程顺序执行
+        par                 切分到线程池中执行
+        par_unseq           切分到线程池，且每一块内部允许向量化（#pragma GCC ivdep）
+        par.with(n)         限定最多使用n个线程（含调用线程），用于测量扩展性
+
+    按迭代器类别在编译期选择实现：
+    * 连续迭代器（vector、array、指针）：转换成裸指针后执行循环体，编译器可以放心地向量化
+    * 随机访问迭代器（deque）：按下标切块，各线程处理自己的块
+    * 其它迭代器（list、输入迭代器）：无法切分，无论什么策略都顺序执行
+    区间太短（不到2 * MinChunk个元素）时，开线程的开销大于收益，同样顺序执行。
+
+    与并行版std::transform一样：out可以等于b（原地），但两个区间不能部分重叠；op不能有数据竞争。
+    op抛出异常时，剩余的元素不再处理，等所有线程都停下后在调用线程重新抛出第一个异常，
+    无论异常发生在调用线程还是工作线程（std::execution的策略在这里会调用std::terminate）。
+*/
+
+namespace Item05_Dwim
+{
+    // 一、执行策略
+    struct sequenced_policy {};
+
+    struct parallel_policy
+    {
+        unsigned threads = 0;       // 0：使用全部硬件线程
+        constexpr parallel_policy with(unsigned n) const noexcept { return { n }; }
+    };
+
+    struct parallel_unsequenced_policy
+    {
+        unsigned threads = 0;
+        constexpr parallel_unsequenced_policy with(unsigned n) const noexcept { return { n }; }
+    };
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+    inline constexpr parallel_unsequenced_policy par_unseq{};
+
+    template<typename P>
+    concept ExecutionPolicy = std::is_same_v<std::remove_cvref_t<P>, sequenced_policy>
+                           || std::is_same_v<std::remove_cvref_t<P>, parallel_policy>
+                           || std::is_same_v<std::remove_cvref_t<P>, parallel_unsequenced_policy>;
+
+
+    // 二、线程池：一次执行一个fork-join任务，调用线程也参与
+    class ThreadPool
+    {
+    public:
+        static ThreadPool& instance()
+        {
+            static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+            return pool;
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& t : workers) t.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const noexcept { return workers.size() + 1; }
+
+        // 对 i = 0..count-1 调用fn(i)，最多threads个线程（含调用线程）同时参与，全部完成后返回
+        // 在工作线程内部再次调用时直接顺序执行，避免嵌套等待造成死锁
+        template<typename F>
+        void parallelFor(std::size_t count, std::size_t threads, F&& fn)
+        {
+            if (count == 0) return;
+            if (threads <= 1 || workers.empty() || insideWorker()) {
+                for (std::size_t i = 0; i < count; ++i) fn(i);
+                return;
+            }
+
+            std::lock_guard<std::mutex> submit(submitMutex);          // 同一时刻只有一个任务
+
+            Job job;
+            job.context = std::addressof(fn);
+            job.invoke = [](void* context, std::size_t i) { (*static_cast<std::remove_reference_t<F>*>(context))(i); };
+            job.count = count;
+            job.helpers = std::min(threads, size()) - 1;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current = &job;
+                ++generation;
+            }
+            wake.notify_all();
+
+            work(job);
+
+            // 等所有已加入的工作线程离开后，job才能销毁
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                current = nullptr;
+                done.wait(lock, [&] { return job.active == 0; });
+            }
+            if (job.error) std::rethrow_exception(job.error);
+        }
+
+    private:
+        struct Job
+        {
+            void* context = nullptr;
+            void (*invoke)(void*, std::size_t) = nullptr;
+            std::size_t count = 0;
+            std::size_t helpers = 0;                 // 允许加入的工作线程数
+            std::atomic<std::size_t> next{ 0 };
+            std::size_t joined = 0;                  // 以下两项受mutex保护
+            std::size_t active = 0;
+            std::atomic<bool> failed{ false };
+            std::exception_ptr error;                // 只由第一个失败的线程写入
+        };
+
+        explicit ThreadPool(unsigned workerCount)
+        {
+            workers.reserve(workerCount);
+            for (unsigned i = 0; i < workerCount; ++i) {
+                workers.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        static bool& insideWorker() noexcept
+        {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        // 不抛出：异常保存在job中，并取走剩余的下标，让其他线程尽快停下
+        static void work(Job& job) noexcept
+        {
+            try {
+                for (std::size_t i; (i = job.next.fetch_add(1, std::memory_order_relaxed)) < job.count;) {
+                    job.invoke(job.context, i);
+                }
+            }
+            catch (...) {
+                job.next.store(job.count, std::memory_order_relaxed);
+                if (!job.failed.exchange(true, std::memory_order_relaxed)) job.error = std::current_exception();
+            }
+        }
+
+        void workerLoop()
+        {
+            insideWorker() = true;
+            std::size_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+
+                Job* job = current;
+                if (!job || job->joined == job->helpers) continue;
+                ++job->joined;
+                ++job->active;
+
+                lock.unlock();
+                work(*job);
+                lock.lock();
+
+                if (--job->active == 0) done.notify_all();
+            }
+        }
+
+        std::mutex submitMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        Job* current = nullptr;
+        std::size_t generation = 0;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+    };
+
+
+    // 三、实现
+    namespace Detail
+    {
+        // 每块至少这么多元素，块数约为线程数的4倍，便于负载均衡
+        inline constexpr std::size_t MinChunk = 16 * 1024;
+
+        template<typename Policy>
+        constexpr bool Unsequenced = std::is_same_v<std::remove_cvref_t<Policy>, parallel_unsequenced_policy>;
+
+        template<typename Policy>
+        std::size_t threadsOf(const Policy& policy)
+        {
+            const std::size_t available = ThreadPool::instance().size();
+            return policy.threads == 0 ? available : std::min<std::size_t>(policy.threads, available);
+        }
+
+        // 连续区间的循环体：指针 + 下标，Unseq时告诉编译器各次迭代互不依赖
+        template<bool Unseq, typename T, typename U, typename Op>
+        void contiguousBody(T* in, U* out, std::size_t n, Op& op)
+        {
+            if constexpr (Unseq) {
+#if defined(__GNUC__) && !defined(__clang__)
+                #pragma GCC ivdep
+#elif defined(__clang__)
+                #pragma clang loop vectorize(assume_safety)
+#endif
+                for (std::size_t i = 0; i < n; ++i) out[i] = op(in[i]);
+            }
+            else {
+                for (std::size_t i = 0; i < n; ++i) out[i] = op(in[i]);
+            }
+        }
+
+        template<bool Unseq, typename InIt, typename OutIt, typename Op>
+        void chunkBody(InIt first, OutIt out, std::size_t n, Op& op)
+        {
+            if constexpr (std::contiguous_iterator<InIt> && std::contiguous_iterator<OutIt>) {
+                if (n > 0) contiguousBody<Unseq>(std::to_address(first), std::to_address(out), n, op);
+            }
+            else {
+                for (std::size_t i = 0; i < n; ++i, ++first, ++out) *out = op(*first);
+            }
+        }
+
+        template<typename InIt, typename OutIt, typename Op>
+        OutIt sequential(InIt first, InIt last, OutIt out, Op& op)
+        {
+            if constexpr (std::random_access_iterator<InIt>) {
+                const auto n = static_cast<std::size_t>(last - first);
+                chunkBody<false>(first, out, n, op);
+                return std::next(out, static_cast<std::iter_difference_t<OutIt>>(n));
+            }
+            else {
+                for (; first != last; ++first, ++out) *out = op(*first);
+                return out;
+            }
+        }
+
+        template<typename Policy, typename InIt, typename OutIt, typename Op>
+        OutIt parallel(const Policy& policy, InIt first, InIt last, OutIt out, Op& op)
+        {
+            const auto n = static_cast<std::size_t>(last - first);
+            const std::size_t threads = threadsOf(policy);
+            const auto end = out + static_cast<std::iter_difference_t<OutIt>>(n);
+
+            if (threads <= 1 || n < 2 * MinChunk) {
+                chunkBody<Unsequenced<Policy>>(first, out, n, op);
+                return end;
+            }
+
+            const std::size_t chunks = std::min(threads * 4, n / MinChunk);
+            const std::size_t chunkSize = (n + chunks - 1) / chunks;
+
+            ThreadPool::instance().parallelFor(chunks, threads, [&](std::size_t c) {
+                const std::size_t begin = c * chunkSize;
+                const std::size_t size = std::min(chunkSize, n - begin);
+                chunkBody<Unsequenced<Policy>>(first + static_cast<std::iter_difference_t<InIt>>(begin),
+                                              out + static_cast<std::iter_difference_t<OutIt>>(begin), size, op);
+            });
+            return end;
+        }
+    }
+
+
+    // 四、对外接口
+    template<ExecutionPolicy Policy, std::input_iterator InIt, typename OutIt, typename Op>
+    OutIt dwim(Policy&& policy, InIt first, InIt last, OutIt out, Op op)
+    {
+        if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, sequenced_policy>
+                      || !std::random_access_iterator<InIt> || !std::random_access_iterator<OutIt>) {
+            return Detail::sequential(first, last, out, op);
+        }
+        else {
+            return Detail::parallel(policy, first, last, out, op);
+        }
+    }
+
+    template<ExecutionPolicy Policy, std::forward_iterator It, typename Op>
+    void dwim(Policy&& policy, It first, It last, Op op)
+    {
+        dwim(std::forward<Policy>(policy), first, last, first, op);
+    }
+
+    inline void test()
+    {
+        std::vector<float> v(1 << 20, 2.0f);
+
+        dwim(seq, v.begin(), v.end(), [](float x) { return x * x; });
+        dwim(par, v.begin(), v.end(), [](float x) { return x + 1.0f; });
+        dwim(par_unseq.with(2), v.begin(), v.end(), [](float x) { return x * 0.5f; });
+
+        std::vector<double> out(v.size());
+        dwim(par, v.begin(), v.end(), out.begin(), [](float x) { return static_cast<double>(x); });
+    }
+}
+
+// 总结
+// * auto让算法不必关心元素的具体类型，迭代器类别（iterator_concept）则决定了算法能怎样切分工作
+// * 连续迭代器可以退化成指针交给向量化，随机访问迭代器可以按下标分给多个线程，其余只能顺序执行
@@ -0,0 +1,571 @@
+/* 条款5 扩展 - 开放寻址的扁平哈希表：flat_hash_map（SwissTable风格） */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define EMCP_FLAT_HASH_SSE2 1
+#else
+    #define EMCP_FLAT_HASH_SSE2 0
+#endif
+
+/*
+    item05.cpp的test2遍历 std::unordered_map<std::string, int>，说明了元素类型是 pair<const std::string, int>。
+    unordered_map本身还有两个与auto无关的开销：
+    * 基于节点：每个元素单独分配，遍历和查找的每一步都是一次指针跳转
+    * m.find("key") 或 m.find(std::string_view) 要先构造一个临时std::string（长键还要堆分配）
+
+    flat_hash_map把所有元素放在一个连续的槽位数组里，另有一个等长的控制字节数组：
+        控制字节 = Empty(0x80) / Deleted(0xFE) / 0~127（哈希值的低7位，H2）
+    查找时用哈希值的其余位（H1）定位起点，一次加载16个控制字节，
+    用SSE2比较出所有H2相同的槽位（_mm_cmpeq_epi8 + _mm_movemask_epi8），只对这些槽位比较键；
+    组内出现Empty就说明键不存在。绝大多数查找只看一组控制字节、比较一次键。
+
+    * 按组做三角探测：第i次探测的起点前进 16 * i，容量为2的幂时可以覆盖所有槽位
+    * 负载因子上限7/8，超过时容量翻倍重建
+    * 删除只把控制字节改为Deleted（墓碑），重建时清除
+    * 键为std::string时使用透明哈希和std::equal_to<>：find/contains/operator[]可以直接接收string_view或const char*，
+      命中时不构造std::string
+    * 迭代器按槽位顺序遍历连续内存，解引用得到 std::pair<const K, V>&
+      与test2相同：遍历时写 for (const auto& p : m)，不要写成 pair<K, V>，否则每个元素都要拷贝一次
+    * 插入可能引起重建，重建后所有迭代器和引用失效（与std::vector相同，与std::unordered_map不同）
+*/
+
+namespace Item05_FlatHashMap
+{
+    // 一、哈希
+    // 字符串类的键统一按string_view计算，std::string、string_view、const char*得到相同的哈希值
+    template<typename K>
+    struct DefaultHash : std::hash<K> {};
+
+    template<>
+    struct DefaultHash<std::string>
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    namespace Detail
+    {
+        // splitmix64的终结函数：std::hash<int>是恒等函数，不打散的话低7位（H2）几乎没有区分度
+        constexpr std::uint64_t mix(std::uint64_t x) noexcept
+        {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+            return x;
+        }
+
+        using Ctrl = std::int8_t;
+        inline constexpr Ctrl Empty = -128;         // 0x80
+        inline constexpr Ctrl Deleted = -2;         // 0xFE
+
+        constexpr bool isFull(Ctrl c) noexcept { return c >= 0; }
+
+        // 16个控制字节为一组；返回的掩码中第i位对应组内第i个槽位
+        struct Group
+        {
+            static constexpr std::size_t Width = 16;
+
+#if EMCP_FLAT_HASH_SSE2
+            explicit Group(const Ctrl* p) noexcept : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+            std::uint32_t match(Ctrl h2) const noexcept
+            {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+            }
+
+            std::uint32_t matchEmpty() const noexcept { return match(Empty); }
+
+            // Empty和Deleted的最高位为1，满槽位为0
+            std::uint32_t matchEmptyOrDeleted() const noexcept
+            {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+            }
+
+            __m128i ctrl;
+#else
+            explicit Group(const Ctrl* p) noexcept { std::memcpy(ctrl, p, Width); }
+
+            std::uint32_t match(Ctrl h2) const noexcept
+            {
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < Width; ++i) mask |= std::uint32_t(ctrl[i] == h2) << i;
+                return mask;
+            }
+
+            std::uint32_t matchEmpty() const noexcept { return match(Empty); }
+
+            std::uint32_t matchEmptyOrDeleted() const noexcept
+            {
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < Width; ++i) mask |= std::uint32_t(ctrl[i] < 0) << i;
+                return mask;
+            }
+
+            Ctrl ctrl[Width];
+#endif
+        };
+
+        // 空表共用的控制字节：全部为Empty，查找时不需要判断容量是否为0
+        alignas(16) inline constexpr Ctrl emptyGroup[Group::Width] = {
+            Empty, Empty, Empty, Empty, Empty, Empty, Empty, Empty,
+            Empty, Empty, Empty, Empty, Empty, Empty, Empty, Empty,
+        };
+    }
+
+
+    // 二、flat_hash_map
+    template<typename K, typename V, typename Hash = DefaultHash<K>, typename Eq = std::equal_to<>>
+    class flat_hash_map
+    {
+        using Ctrl = Detail::Ctrl;
+        using Group = Detail::Group;
+
+        // 可以直接用Q查找：Q就是K，或者Hash、Eq都是透明的且能比较K与Q
+        template<typename Q>
+        static constexpr bool Transparent = std::is_same_v<Q, K>
+            || (requires { typename Hash::is_transparent; typename Eq::is_transparent; }
+                && std::is_invocable_r_v<bool, const Eq&, const K&, const Q&>);
+
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<const K, V>;
+        using size_type = std::size_t;
+        using hasher = Hash;
+        using key_equal = Eq;
+
+        template<bool Const>
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = flat_hash_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, const value_type&, value_type&>;
+            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+            Iterator() = default;
+            operator Iterator<true>() const noexcept { return { ctrl, slot, last }; }
+
+            reference operator*() const noexcept { return *slot; }
+            pointer operator->() const noexcept { return slot; }
+
+            Iterator& operator++() noexcept
+            {
+                ++ctrl;
+                ++slot;
+                skipEmpty();
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.slot == b.slot; }
+
+        private:
+            friend class flat_hash_map;
+            template<bool> friend class Iterator;
+
+            Iterator(const Ctrl* ctrl, pointer slot, const Ctrl* last) noexcept : ctrl(ctrl), slot(slot), last(last) {}
+
+            void skipEmpty() noexcept
+            {
+                while (ctrl != last && !Detail::isFull(*ctrl)) {
+                    ++ctrl;
+                    ++slot;
+                }
+            }
+
+            const Ctrl* ctrl = nullptr;
+            pointer slot = nullptr;
+            const Ctrl* last = nullptr;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        flat_hash_map() = default;
+
+        flat_hash_map(std::initializer_list<value_type> init)
+        {
+            reserve(init.size());
+            try {
+                for (const auto& v : init) insert(v);
+            }
+            catch (...) {
+                destroyAll();                       // 构造函数抛出时不会调用析构函数
+                throw;
+            }
+        }
+
+        flat_hash_map(const flat_hash_map& other) : hash(other.hash), eq(other.eq)
+        {
+            reserve(other.size());
+            try {
+                for (const auto& v : other) insertUnique(v.first, v.second);
+            }
+            catch (...) {
+                destroyAll();
+                throw;
+            }
+        }
+
+        flat_hash_map(flat_hash_map&& other) noexcept
+            : ctrl(std::exchange(other.ctrl, const_cast<Ctrl*>(Detail::emptyGroup))),
+              slots(std::exchange(other.slots, nullptr)),
+              capacity_(std::exchange(other.capacity_, 0)),
+              size_(std::exchange(other.size_, 0)),
+              growthLeft(std::exchange(other.growthLeft, 0)),
+              hash(other.hash), eq(other.eq)
+        {
+        }
+
+        flat_hash_map& operator=(flat_hash_map other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~flat_hash_map() { destroyAll(); }
+
+        void swap(flat_hash_map& other) noexcept
+        {
+            std::swap(ctrl, other.ctrl);
+            std::swap(slots, other.slots);
+            std::swap(capacity_, other.capacity_);
+            std::swap(size_, other.size_);
+            std::swap(growthLeft, other.growthLeft);
+            std::swap(hash, other.hash);
+            std::swap(eq, other.eq);
+        }
+
+        // 迭代
+        iterator begin() noexcept { return makeBegin<false>(); }
+        iterator end() noexcept { return { ctrl + capacity_, slots + capacity_, ctrl + capacity_ }; }
+        const_iterator begin() const noexcept { return const_cast<flat_hash_map*>(this)->begin(); }
+        const_iterator end() const noexcept { return const_cast<flat_hash_map*>(this)->end(); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        // 容量
+        size_type size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        size_type capacity() const noexcept { return capacity_; }
+
+        void reserve(size_type n)
+        {
+            if (n > maxLoad(capacity_)) rehash(capacityFor(n));
+        }
+
+        void clear() noexcept
+        {
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (Detail::isFull(ctrl[i])) slots[i].~value_type();
+            }
+            if (capacity_ > 0) {
+                std::memset(ctrl, static_cast<unsigned char>(Detail::Empty), capacity_ + Group::Width);
+            }
+            size_ = 0;
+            growthLeft = maxLoad(capacity_);
+        }
+
+        // 查找：Q可以是K，或者在Hash、Eq都透明时与K可比较的类型（如string_view）
+        template<typename Q = K>
+            requires Transparent<Q>
+        iterator find(const Q& key)
+        {
+            const size_type i = findIndex(key);
+            return i == npos ? end() : iteratorAt(i);
+        }
+
+        template<typename Q = K>
+            requires Transparent<Q>
+        const_iterator find(const Q& key) const
+        {
+            return const_cast<flat_hash_map*>(this)->find(key);
+        }
+
+        template<typename Q = K>
+            requires Transparent<Q>
+        bool contains(const Q& key) const { return findIndex(key) != npos; }
+
+        template<typename Q = K>
+            requires Transparent<Q>
+        size_type count(const Q& key) const { return contains(key) ? 1 : 0; }
+
+        template<typename Q = K>
+            requires Transparent<Q>
+        V& at(const Q& key)
+        {
+            const size_type i = findIndex(key);
+            if (i == npos) throw std::out_of_range("flat_hash_map::at");
+            return slots[i].second;
+        }
+
+        template<typename Q = K>
+            requires Transparent<Q>
+        const V& at(const Q& key) const { return const_cast<flat_hash_map*>(this)->at(key); }
+
+        // 插入
+        // 只有真正插入时才用key构造K：m[std::string_view("name")]命中时不分配
+        template<typename Q, typename... Args>
+            requires Transparent<std::remove_cvref_t<Q>> && std::is_constructible_v<K, Q&&>
+        std::pair<iterator, bool> try_emplace(Q&& key, Args&&... args)
+        {
+            const std::uint64_t h = hashOf(key);
+            const size_type found = findIndex(key, h);
+            if (found != npos) return { iteratorAt(found), false };
+
+            const size_type i = prepareInsert(h);
+            ::new (static_cast<void*>(slots + i)) value_type(std::piecewise_construct,
+                                                             std::forward_as_tuple(std::forward<Q>(key)),
+                                                             std::forward_as_tuple(std::forward<Args>(args)...));
+            commitInsert(i, h);
+            return { iteratorAt(i), true };
+        }
+
+        template<typename Q, typename... Args>
+        std::pair<iterator, bool> emplace(Q&& key, Args&&... args)
+        {
+            return try_emplace(std::forward<Q>(key), std::forward<Args>(args)...);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+        std::pair<iterator, bool> insert(value_type&& v) { return try_emplace(v.first, std::move(v.second)); }
+
+        template<typename Q>
+            requires Transparent<std::remove_cvref_t<Q>> && std::is_constructible_v<K, Q&&>
+        V& operator[](Q&& key)
+        {
+            return try_emplace(std::forward<Q>(key)).first->second;
+        }
+
+        V& operator[](const K& key) { return try_emplace(key).first->second; }
+        V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+        // 删除：留下墓碑，保证经过此处的探测序列不中断
+        template<typename Q = K>
+            requires Transparent<Q>
+        size_type erase(const Q& key)
+        {
+            const size_type i = findIndex(key);
+            if (i == npos) return 0;
+            eraseAt(i);
+            return 1;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            const auto i = static_cast<size_type>(pos.slot - slots);
+            eraseAt(i);
+            iterator next = iteratorAt(i);
+            next.skipEmpty();
+            return next;
+        }
+
+    private:
+        static constexpr size_type maxLoad(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+        static size_type capacityFor(size_type n) noexcept
+        {
+            // 容量至少为一组，且保证n个元素不超过7/8的负载
+            const size_type needed = n + (n + 6) / 7;
+            return std::max<size_type>(Group::Width, std::bit_ceil(needed));
+        }
+
+        template<typename Q>
+        std::uint64_t hashOf(const Q& key) const
+        {
+            return Detail::mix(static_cast<std::uint64_t>(hash(key)));
+        }
+
+        static Ctrl h2(std::uint64_t h) noexcept { return static_cast<Ctrl>(h & 0x7f); }
+
+        template<typename Q>
+        size_type findIndex(const Q& key) const
+        {
+            return findIndex(key, hashOf(key));
+        }
+
+        template<typename Q>
+        size_type findIndex(const Q& key, std::uint64_t h) const
+        {
+            const size_type mask = capacity_ == 0 ? 0 : capacity_ - 1;
+            size_type pos = static_cast<size_type>(h >> 7) & mask;
+            const Ctrl tag = h2(h);
+
+            for (size_type step = Group::Width;; step += Group::Width) {
+                const Group g(ctrl + pos);
+                for (std::uint32_t m = g.match(tag); m != 0; m &= m - 1) {
+                    const size_type i = (pos + static_cast<size_type>(std::countr_zero(m))) & mask;
+                    if (eq(slots[i].first, key)) return i;
+                }
+                if (g.matchEmpty() != 0) return npos;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        // 找到探测序列上第一个Empty或Deleted槽位；空间不足时先扩容
+        // 只选出槽位，不修改控制字节：元素构造成功后再调用commitInsert，构造抛出时表保持原样
+        size_type prepareInsert(std::uint64_t h)
+        {
+            size_type i = findFirstNonFull(h);
+            if (growthLeft == 0 && ctrl[i] != Detail::Deleted) {
+                // 墓碑很多时容量不变，只是重建以清除墓碑
+                rehash(size_ + 1 > maxLoad(capacity_) / 2 ? capacityFor(size_ + 1) : capacity_);
+                i = findFirstNonFull(h);
+            }
+            return i;
+        }
+
+        void commitInsert(size_type i, std::uint64_t h) noexcept
+        {
+            if (ctrl[i] == Detail::Empty) --growthLeft;
+            setCtrl(i, h2(h));
+            ++size_;
+        }
+
+        size_type findFirstNonFull(std::uint64_t h) const noexcept
+        {
+            const size_type mask = capacity_ == 0 ? 0 : capacity_ - 1;
+            size_type pos = static_cast<size_type>(h >> 7) & mask;
+            for (size_type step = Group::Width;; step += Group::Width) {
+                const std::uint32_t m = Group(ctrl + pos).matchEmptyOrDeleted();
+                if (m != 0) return (pos + static_cast<size_type>(std::countr_zero(m))) & mask;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        // 控制字节数组末尾多出一组，镜像开头的Width个字节，使从任意位置开始的16字节加载都不越界
+        void setCtrl(size_type i, Ctrl c) noexcept
+        {
+            ctrl[i] = c;
+            if (i < Group::Width) ctrl[capacity_ + i] = c;
+        }
+
+        void eraseAt(size_type i) noexcept
+        {
+            slots[i].~value_type();
+            setCtrl(i, Detail::Deleted);
+            --size_;
+        }
+
+        // 重建：把旧元素移动到新数组中
+        // 槽位里是pair<const K, V>，这里把旧槽位的键当作可修改的对象移动出来，旧槽位随即析构
+        void rehash(size_type newCapacity)
+        {
+            if (capacity_ == 0 && newCapacity == 0) return;
+
+            // 两个数组都分配成功后才修改成员：分配抛出时表保持原样
+            std::unique_ptr<Ctrl[]> newCtrl(new Ctrl[newCapacity + Group::Width]);
+            value_type* newSlots = std::allocator<value_type>{}.allocate(newCapacity);
+            std::memset(newCtrl.get(), static_cast<unsigned char>(Detail::Empty), newCapacity + Group::Width);
+
+            Ctrl* oldCtrl = std::exchange(ctrl, newCtrl.release());
+            value_type* oldSlots = std::exchange(slots, newSlots);
+            const size_type oldCapacity = std::exchange(capacity_, newCapacity);
+            growthLeft = maxLoad(newCapacity) - size_;
+
+            for (size_type i = 0; i < oldCapacity; ++i) {
+                if (!Detail::isFull(oldCtrl[i])) continue;
+                value_type& old = oldSlots[i];
+                const std::uint64_t h = hashOf(old.first);
+                const size_type j = findFirstNonFull(h);
+                setCtrl(j, h2(h));
+                ::new (static_cast<void*>(slots + j)) value_type(std::move(const_cast<K&>(old.first)), std::move(old.second));
+                old.~value_type();
+            }
+
+            if (oldCapacity > 0) {
+                delete[] oldCtrl;
+                std::allocator<value_type>{}.deallocate(oldSlots, oldCapacity);
+            }
+        }
+
+        template<typename Ks, typename Vs>
+        void insertUnique(Ks&& key, Vs&& value)
+        {
+            const std::uint64_t h = hashOf(key);
+            const size_type i = prepareInsert(h);
+            ::new (static_cast<void*>(slots + i)) value_type(std::forward<Ks>(key), std::forward<Vs>(value));
+            commitInsert(i, h);
+        }
+
+        void destroyAll() noexcept
+        {
+            if (capacity_ == 0) return;
+            clear();
+            delete[] ctrl;
+            std::allocator<value_type>{}.deallocate(slots, capacity_);
+        }
+
+        template<bool Const>
+        Iterator<Const> makeBegin() noexcept
+        {
+            Iterator<Const> it{ ctrl, slots, ctrl + capacity_ };
+            it.skipEmpty();
+            return it;
+        }
+
+        iterator iteratorAt(size_type i) noexcept { return { ctrl + i, slots + i, ctrl + capacity_ }; }
+
+        Ctrl* ctrl = const_cast<Ctrl*>(Detail::emptyGroup);
+        value_type* slots = nullptr;
+        size_type capacity_ = 0;
+        size_type size_ = 0;
+        size_type growthLeft = 0;
+        [[no_unique_address]] Hash hash;
+        [[no_unique_address]] Eq eq;
+    };
+
+    inline void test()
+    {
+        flat_hash_map<std::string, int> m{ { "alpha", 1 }, { "beta", 2 } };
+
+        m["gamma"] = 3;
+        m[std::string_view("alpha")] += 10;                 // 命中：不构造std::string
+
+        bool hit = m.contains("beta");                      // const char*直接查找
+        auto it = m.find(std::string_view("delta"));        // 未命中：同样不构造std::string
+
+        // 与test2相同：元素类型是pair<const std::string, int>，用auto避免拷贝
+        int total = 0;
+        for (const auto& p : m) total += p.second;
+
+        m.erase("beta");
+
+        (void)hit; (void)it;
+    }
+}
+
+// 总结
+// * 基于节点的容器每个元素一次分配，每一步访问一次指针跳转；开放寻址把元素放在连续内存中
+// * 控制字节 + SIMD让一次比较筛掉16个槽位，键的比较几乎只发生在真正命中的槽位上
+// * 透明哈希（is_transparent）让string_view、const char*可以直接查找，不必构造临时std::string
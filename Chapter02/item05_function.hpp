@@ -0,0 +1,249 @@
+/* 条款5 扩展 - 不分配内存的类型擦除：inplace_function 与 function_ref */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+    item05.cpp中对比了两种保存比较函数的方式：
+
+        std::function<bool(const std::unique_ptr<Widget>&, const std::unique_ptr<Widget>&)> derefUPLess = [](...) { ... };
+        auto derefUPLess2 = [](...) { ... };
+
+    std::function的问题：闭包超过内部缓冲区（libstdc++为16字节）时在堆上分配；每次调用都是一次间接调用。
+    auto没有这些开销，但有些回调必须类型擦除（存进成员变量、跨越编译单元、放进容器）。
+    这里提供两个折中方案：
+
+    * inplace_function<R(Args...), Capacity>
+        拥有闭包，闭包直接存放在对象内部Capacity字节的缓冲区中，永远不分配内存；
+        闭包放不下时编译失败（static_assert），而不是悄悄退化成堆分配。
+        调用时只有一次间接调用（直接保存调用函数的指针，不经过虚表）。
+        为空时调用抛出std::bad_function_call，与std::function一致。
+
+    * function_ref<R(Args...)>
+        不拥有闭包，只保存"对象地址 + 调用函数指针"两个指针，构造和拷贝都是零开销。
+        适合作为函数参数：调用方的闭包在整个调用期间都存活。
+        不能保存下来在原闭包销毁后使用（与std::string_view同理）。
+*/
+
+namespace Item05_Function
+{
+    template<typename Signature, std::size_t Capacity = 32, std::size_t Alignment = alignof(std::max_align_t)>
+    class inplace_function;
+
+    template<typename R, typename... Args, std::size_t Capacity, std::size_t Alignment>
+    class inplace_function<R(Args...), Capacity, Alignment>
+    {
+    public:
+        inplace_function() noexcept = default;
+        inplace_function(std::nullptr_t) noexcept {}
+
+        template<typename F>
+            requires (!std::is_same_v<std::remove_cvref_t<F>, inplace_function>)
+                  && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>
+        inplace_function(F&& f)
+        {
+            using Closure = std::decay_t<F>;
+            static_assert(sizeof(Closure) <= Capacity, "闭包超出inplace_function的容量，请增大Capacity或减少捕获");
+            static_assert(Alignment % alignof(Closure) == 0, "闭包的对齐要求超出inplace_function的Alignment");
+            static_assert(std::is_copy_constructible_v<Closure>, "inplace_function要求闭包可拷贝（与std::function相同）");
+
+            ::new (static_cast<void*>(storage)) Closure(std::forward<F>(f));
+            invoker = &invokeClosure<Closure>;
+            if constexpr (!std::is_trivially_copyable_v<Closure>) ops = &opsFor<Closure>;
+        }
+
+        inplace_function(const inplace_function& other) : invoker(other.invoker), ops(other.ops)
+        {
+            copyFrom(other);
+        }
+
+        // 移动后other为空：闭包已经搬到this中，other的那份已销毁
+        inplace_function(inplace_function&& other) noexcept : invoker(other.invoker), ops(other.ops)
+        {
+            moveFrom(other);
+        }
+
+        inplace_function& operator=(const inplace_function& other)
+        {
+            if (this != &other) {
+                inplace_function copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        inplace_function& operator=(inplace_function&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                invoker = other.invoker;
+                ops = other.ops;
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        inplace_function& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        ~inplace_function() { reset(); }
+
+        R operator()(Args... args) const
+        {
+            return invoker(const_cast<unsigned char*>(storage), std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept { return invoker != &invokeEmpty; }
+
+    private:
+        struct Ops
+        {
+            void (*copy)(void* dst, const void* src);
+            void (*move)(void* dst, void* src) noexcept;        // 移动构造到dst，并销毁src
+            void (*destroy)(void* p) noexcept;
+        };
+
+        template<typename Closure>
+        static R invokeClosure(void* p, Args&&... args)
+        {
+            return std::invoke(*static_cast<Closure*>(p), std::forward<Args>(args)...);
+        }
+
+        [[noreturn]] static R invokeEmpty(void*, Args&&...) { throw std::bad_function_call(); }
+
+        template<typename Closure>
+        static constexpr Ops opsFor{
+            [](void* dst, const void* src) { ::new (dst) Closure(*static_cast<const Closure*>(src)); },
+            [](void* dst, void* src) noexcept {
+                ::new (dst) Closure(std::move(*static_cast<Closure*>(src)));
+                static_cast<Closure*>(src)->~Closure();
+            },
+            [](void* p) noexcept { static_cast<Closure*>(p)->~Closure(); },
+        };
+
+        // 调用前invoker、ops已从other复制
+        void copyFrom(const inplace_function& other)
+        {
+            if (ops) ops->copy(storage, other.storage);
+            else std::memcpy(storage, other.storage, Capacity);
+        }
+
+        void moveFrom(inplace_function& other) noexcept
+        {
+            if (ops) ops->move(storage, other.storage);
+            else std::memcpy(storage, other.storage, Capacity);
+            other.invoker = &invokeEmpty;
+            other.ops = nullptr;
+        }
+
+        void reset() noexcept
+        {
+            if (ops) ops->destroy(storage);
+            invoker = &invokeEmpty;
+            ops = nullptr;
+        }
+
+        // 为空时invoker指向invokeEmpty，调用路径上不需要判空
+        // 可平凡拷贝的闭包（只捕获指针、数值的lambda）没有ops：拷贝、移动就是memcpy，析构什么也不做。
+        // std::sort等算法会按值反复传递比较器，这一点对它们很重要
+        R (*invoker)(void*, Args&&...) = &invokeEmpty;
+        const Ops* ops = nullptr;
+        alignas(Alignment) unsigned char storage[Capacity];
+    };
+
+
+    template<typename Signature>
+    class function_ref;
+
+    template<typename R, typename... Args>
+    class function_ref<R(Args...)>
+    {
+    public:
+        // 普通函数（或函数指针）
+        template<typename F>
+            requires std::is_function_v<F> && std::is_invocable_r_v<R, F&, Args...>
+        function_ref(F* f) noexcept
+            : object(reinterpret_cast<void*>(f)),
+              invoker([](void* p, Args&&... args) -> R {
+                  return std::invoke(reinterpret_cast<F*>(p), std::forward<Args>(args)...);
+              })
+        {
+        }
+
+        // 任意可调用对象：只记录它的地址
+        template<typename F>
+            requires (!std::is_same_v<std::remove_cvref_t<F>, function_ref>)
+                  && (!std::is_pointer_v<std::remove_cvref_t<F>>)
+                  && (!std::is_function_v<std::remove_reference_t<F>>)
+                  && std::is_invocable_r_v<R, F&, Args...>
+        function_ref(F&& f) noexcept
+            : object(const_cast<void*>(static_cast<const void*>(std::addressof(f)))),
+              invoker([](void* p, Args&&... args) -> R {
+                  return std::invoke(*static_cast<std::remove_reference_t<F>*>(p), std::forward<Args>(args)...);
+              })
+        {
+        }
+
+        function_ref(const function_ref&) noexcept = default;
+        function_ref& operator=(const function_ref&) noexcept = default;
+
+        R operator()(Args... args) const
+        {
+            return invoker(object, std::forward<Args>(args)...);
+        }
+
+    private:
+        void* object;
+        R (*invoker)(void*, Args&&...);
+    };
+
+    namespace Example
+    {
+        class Widget
+        {
+        public:
+            explicit Widget(int v = 0) : value(v) {}
+            bool operator<(const Widget& rhs) const { return value < rhs.value; }
+
+        private:
+            int value;
+        };
+    }
+
+    inline void test()
+    {
+        using Example::Widget;
+        using DerefUPLess = bool(const std::unique_ptr<Widget>&, const std::unique_ptr<Widget>&);
+
+        auto derefUPLess = [](const std::unique_ptr<Widget>& p1, const std::unique_ptr<Widget>& p2) { return *p1 < *p2; };
+
+        std::function<DerefUPLess> f1 = derefUPLess;          // 空闭包，不分配；捕获较多时会分配
+        inplace_function<DerefUPLess> f2 = derefUPLess;       // 永不分配
+        function_ref<DerefUPLess> f3 = derefUPLess;           // 只引用derefUPLess
+
+        auto a = std::make_unique<Widget>(1);
+        auto b = std::make_unique<Widget>(2);
+        bool r = f1(a, b) && f2(a, b) && f3(a, b);
+
+        double w = 1, x = 2, y = 3, z = 4;
+        inplace_function<double(), 32> sum = [w, x, y, z] { return w + x + y + z; };    // 32字节，刚好放下
+        // inplace_function<double(), 16> small = [w, x, y, z] { return w + x + y + z; }; // 编译错误：超出容量
+
+        (void)r;
+    }
+}
+
+// 总结
+// * 不需要类型擦除时，用auto保存闭包
+// * 需要保存回调又不想分配时，用inplace_function，容量不足在编译期暴露
+// * 回调只在函数调用期间使用时，用function_ref作为参数类型
@@ -0,0 +1,131 @@
+/* 条款5 扩展 - 对unique_ptr<Widget>容器做缓存友好的排序：indirect_sort */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item05.cpp中的比较函数：
+
+        auto derefUPLess = [](const std::unique_ptr<Widget>& p1, const std::unique_ptr<Widget>& p2) { return *p1 < *p2; };
+        auto derefLess = [](const auto& p1, const auto& p2) { return *p1 < *p2; };
+
+    用它们对 std::vector<std::unique_ptr<Widget>> 排序时，每次比较都要解引用两个指针。
+    Widget散落在堆上，n很大时几乎每次解引用都是一次缓存未命中，而std::sort要做约 n*log2(n) 次比较。
+
+    indirect_sort把"追指针"从 n*log(n) 次降到 n 次：
+    1. 顺序扫描一遍，把每个元素的键取出来，和它的下标一起放进连续的 (key, index) 数组
+    2. 对这个数组排序：比较只涉及连续内存中的键，不再解引用
+    3. 按排好的下标把原来的指针移动到新位置
+
+    * key(x)默认就是 *p 的拷贝（适合小的、可平凡拷贝的Widget），也可以传入投影函数，只取参与比较的字段
+    * comp默认为std::less<>，与derefLess中的 *p1 < *p2 一致
+    * 键相等时按原下标排序，因此结果是稳定的
+    * 额外内存：n个(key, index)和n个元素的临时缓冲区
+*/
+
+namespace Item05_IndirectSort
+{
+    namespace Detail
+    {
+        template<typename Key, typename Index>
+        struct Entry
+        {
+            Key key;
+            Index index;
+        };
+
+        template<typename Index, typename It, typename Proj, typename Comp>
+        void sortBy(It first, std::size_t n, Proj& proj, Comp& comp)
+        {
+            using Key = std::remove_cvref_t<std::invoke_result_t<Proj&, decltype(*(*first))>>;
+            using Value = std::iter_value_t<It>;
+
+            // 1、唯一一次解引用：按顺序取出键
+            std::vector<Entry<Key, Index>> entries;
+            entries.reserve(n);
+            {
+                It it = first;
+                for (std::size_t i = 0; i < n; ++i, ++it) {
+                    entries.push_back({ std::invoke(proj, *(*it)), static_cast<Index>(i) });
+                }
+            }
+
+            // 2、只在连续的键上比较
+            std::sort(entries.begin(), entries.end(), [&](const auto& a, const auto& b) {
+                if (std::invoke(comp, a.key, b.key)) return true;
+                if (std::invoke(comp, b.key, a.key)) return false;
+                return a.index < b.index;
+            });
+
+            // 3、按新顺序把指针移动出来，再整体移动回去
+            std::vector<Value> sorted;
+            sorted.reserve(n);
+            for (const auto& e : entries) sorted.push_back(std::move(first[static_cast<std::iter_difference_t<It>>(e.index)]));
+            std::move(sorted.begin(), sorted.end(), first);
+        }
+    }
+
+    template<std::random_access_iterator It, typename Proj = std::identity, typename Comp = std::less<>>
+    void indirect_sort(It first, It last, Proj proj = {}, Comp comp = {})
+    {
+        const auto n = static_cast<std::size_t>(last - first);
+        if (n < 2) return;
+
+        // 下标尽量用32位，(key, index)数组更紧凑
+        if (n <= std::numeric_limits<std::uint32_t>::max()) {
+            Detail::sortBy<std::uint32_t>(first, n, proj, comp);
+        }
+        else {
+            Detail::sortBy<std::size_t>(first, n, proj, comp);
+        }
+    }
+
+    template<typename Range, typename Proj = std::identity, typename Comp = std::less<>>
+    void indirect_sort(Range& range, Proj proj = {}, Comp comp = {})
+    {
+        indirect_sort(std::begin(range), std::end(range), std::move(proj), std::move(comp));
+    }
+
+    namespace Example
+    {
+        class Widget
+        {
+        public:
+            explicit Widget(int priority = 0) : priority(priority) {}
+
+            bool operator<(const Widget& rhs) const { return priority < rhs.priority; }
+            int key() const { return priority; }
+
+        private:
+            int priority;
+        };
+    }
+
+    inline void test()
+    {
+        using Example::Widget;
+
+        std::vector<std::unique_ptr<Widget>> widgets;
+        for (int p : { 5, 1, 4, 2, 3 }) widgets.push_back(std::make_unique<Widget>(p));
+
+        auto derefLess = [](const auto& p1, const auto& p2) { return *p1 < *p2; };
+        std::sort(widgets.begin(), widgets.end(), derefLess);           // 每次比较解引用两次
+
+        indirect_sort(widgets);                                          // 键为Widget的拷贝，用Widget::operator<比较
+        indirect_sort(widgets, &Widget::key, std::greater<>{});          // 只取出int键，降序
+    }
+}
+
+// 总结
+// * 比较函数里的 *p1 < *p2 看起来很便宜，但在大容器上它是一次随机访存
+// * 先把键取到连续内存中再排序，解引用次数从 O(n log n) 降到 O(n)
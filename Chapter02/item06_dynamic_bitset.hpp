@@ -0,0 +1,417 @@
+/* 条款6 扩展 - 按64位字打包的位集合：dynamic_bitset */
+
+#pragma once
+
+#include "../Chapter01/item01_fixed_search.hpp"     // EMCP_FIXED_SEARCH_SIMD、hasAvx2()
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+/*
+    item06.cpp中的features(w)每次调用都返回一个新的std::vector<bool>，调用方再通过
+    std::vector<bool>::reference这个代理类取出bool：
+    * 每次调用一次堆分配
+    * auto highPriority = features(w)[5]; 推导出的是代理类，features(w)析构后它就悬空了
+    * vector<bool>没有按字访问的接口，两个特征掩码求与、求交集的个数只能逐位循环
+
+    dynamic_bitset：
+    * 以64位字存储，字数组按缓存行（64字节）对齐；最后一个字中超出size()的位恒为0
+    * operator[]返回bool而不是代理类：auto b = bits[5]; 得到的就是bool。写入使用set/reset/flip
+    * &= |= ^= andnot（a &= ~b）、count按字批量处理，运行时支持AVX2时每次处理4个字（256位）
+    * find_first/find_next用countr_zero跳过全0的字，遍历稀疏集合时只访问置位的位
+    * features_into(w, bits)复用调用方的存储：resize不缩小字数组的容量，批量处理时只在第一次分配
+
+    二元运算要求两个位集合的size()相同（与boost::dynamic_bitset一致），不同时结果未定义。
+*/
+
+namespace Item06_DynamicBitset
+{
+    // 一、按缓存行对齐的分配器
+    template<typename T>
+    struct CacheAlignedAllocator
+    {
+        using value_type = T;
+        static constexpr std::size_t Alignment = 64;
+
+        CacheAlignedAllocator() noexcept = default;
+        template<typename U>
+        CacheAlignedAllocator(const CacheAlignedAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ Alignment }));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            ::operator delete(p, n * sizeof(T), std::align_val_t{ Alignment });
+        }
+
+        template<typename U>
+        bool operator==(const CacheAlignedAllocator<U>&) const noexcept { return true; }
+    };
+
+
+    // 二、按字批量运算
+    namespace Detail
+    {
+        using Word = std::uint64_t;
+
+        enum class Op { And, Or, Xor, AndNot };
+
+        template<Op op>
+        inline Word apply(Word a, Word b) noexcept
+        {
+            if constexpr (op == Op::And) return a & b;
+            else if constexpr (op == Op::Or) return a | b;
+            else if constexpr (op == Op::Xor) return a ^ b;
+            else return a & ~b;
+        }
+
+        // 字数组都按32字节以上对齐，可以使用对齐加载；返回已处理的字数（4的整数倍），尾部由调用方处理
+#if EMCP_FIXED_SEARCH_SIMD
+        #pragma GCC push_options
+        #pragma GCC target("avx2")
+        namespace Avx2
+        {
+            template<Op op>
+            std::size_t apply(Word* dst, const Word* src, std::size_t n) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const auto a = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+                    const auto b = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i));
+                    __m256i r;
+                    if constexpr (op == Op::And) r = _mm256_and_si256(a, b);
+                    else if constexpr (op == Op::Or) r = _mm256_or_si256(a, b);
+                    else if constexpr (op == Op::Xor) r = _mm256_xor_si256(a, b);
+                    else r = _mm256_andnot_si256(b, a);     // andnot(x, y) = ~x & y
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), r);
+                }
+                return i;
+            }
+
+            // 查表法（Muła）：每个字节拆成两个4位，用vpshufb查出各自的1的个数，再用vpsadbw横向求和成4个64位计数
+            inline __m256i popcount4(__m256i v) noexcept
+            {
+                const auto lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+                const auto lowMask = _mm256_set1_epi8(0x0f);
+                const auto lo = _mm256_and_si256(v, lowMask);
+                const auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+                const auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+                return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+            }
+
+            inline std::uint64_t sum4(__m256i acc) noexcept
+            {
+                alignas(32) std::uint64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+                return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            }
+
+            // p不要求对齐：也用于统计字数组中间的一段
+            inline std::size_t popcount(const Word* p, std::size_t n, std::uint64_t& total) noexcept
+            {
+                auto acc = _mm256_setzero_si256();
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    acc = _mm256_add_epi64(acc, popcount4(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))));
+                }
+                total = sum4(acc);
+                return i;
+            }
+
+            // popcount(a op b)：不写出运算结果
+            template<Op op>
+            std::size_t popcount(const Word* a, const Word* b, std::size_t n, std::uint64_t& total) noexcept
+            {
+                auto acc = _mm256_setzero_si256();
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const auto x = _mm256_load_si256(reinterpret_cast<const __m256i*>(a + i));
+                    const auto y = _mm256_load_si256(reinterpret_cast<const __m256i*>(b + i));
+                    __m256i r;
+                    if constexpr (op == Op::And) r = _mm256_and_si256(x, y);
+                    else if constexpr (op == Op::Or) r = _mm256_or_si256(x, y);
+                    else if constexpr (op == Op::Xor) r = _mm256_xor_si256(x, y);
+                    else r = _mm256_andnot_si256(y, x);
+                    acc = _mm256_add_epi64(acc, popcount4(r));
+                }
+                total = sum4(acc);
+                return i;
+            }
+        }
+        #pragma GCC pop_options
+#endif
+
+        template<Op op>
+        void apply(Word* dst, const Word* src, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+#if EMCP_FIXED_SEARCH_SIMD
+            if (n >= 4 && Item01_FixedSearch::hasAvx2()) i = Avx2::apply<op>(dst, src, n);
+#endif
+            for (; i < n; ++i) dst[i] = apply<op>(dst[i], src[i]);
+        }
+
+        inline std::size_t popcount(const Word* p, std::size_t n) noexcept
+        {
+            std::uint64_t total = 0;
+            std::size_t i = 0;
+#if EMCP_FIXED_SEARCH_SIMD
+            if (n >= 4 && Item01_FixedSearch::hasAvx2()) i = Avx2::popcount(p, n, total);
+#endif
+            for (; i < n; ++i) total += static_cast<std::uint64_t>(std::popcount(p[i]));
+            return static_cast<std::size_t>(total);
+        }
+
+        template<Op op>
+        std::size_t popcount(const Word* a, const Word* b, std::size_t n) noexcept
+        {
+            std::uint64_t total = 0;
+            std::size_t i = 0;
+#if EMCP_FIXED_SEARCH_SIMD
+            if (n >= 4 && Item01_FixedSearch::hasAvx2()) i = Avx2::popcount<op>(a, b, n, total);
+#endif
+            for (; i < n; ++i) total += static_cast<std::uint64_t>(std::popcount(apply<op>(a[i], b[i])));
+            return static_cast<std::size_t>(total);
+        }
+    }
+
+
+    // 三、dynamic_bitset
+    class dynamic_bitset
+    {
+    public:
+        using word_type = Detail::Word;
+        using size_type = std::size_t;
+
+        static constexpr size_type WordBits = 64;
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        dynamic_bitset() = default;
+
+        explicit dynamic_bitset(size_type bits, bool value = false)
+        {
+            resize(bits, value);
+        }
+
+        size_type size() const noexcept { return bits; }
+        bool empty() const noexcept { return bits == 0; }
+
+        // 按字访问：最后一个字中超出size()的位为0，写入时调用方也必须保持这一点
+        size_type word_count() const noexcept { return words.size(); }
+        const word_type* data() const noexcept { return words.data(); }
+        word_type* data() noexcept { return words.data(); }
+
+        // 新增的位取value；只增不减字数组的容量，反复resize不会重新分配
+        void resize(size_type n, bool value = false)
+        {
+            const size_type old = bits;
+            words.resize(wordsFor(n), value ? ~word_type(0) : word_type(0));
+            if (value && n > old && old % WordBits != 0) words[old / WordBits] |= ~word_type(0) << (old % WordBits);
+            bits = n;
+            trim();
+        }
+
+        void clear() noexcept
+        {
+            words.clear();
+            bits = 0;
+        }
+
+        // 返回bool而不是代理类：auto取到的是值
+        bool operator[](size_type i) const noexcept { return test(i); }
+
+        bool test(size_type i) const noexcept
+        {
+            return (words[i / WordBits] >> (i % WordBits)) & 1;
+        }
+
+        dynamic_bitset& set(size_type i, bool value = true) noexcept
+        {
+            const word_type mask = word_type(1) << (i % WordBits);
+            word_type& w = words[i / WordBits];
+            w = value ? (w | mask) : (w & ~mask);
+            return *this;
+        }
+
+        dynamic_bitset& reset(size_type i) noexcept { return set(i, false); }
+
+        dynamic_bitset& flip(size_type i) noexcept
+        {
+            words[i / WordBits] ^= word_type(1) << (i % WordBits);
+            return *this;
+        }
+
+        dynamic_bitset& set() noexcept
+        {
+            std::fill(words.begin(), words.end(), ~word_type(0));
+            trim();
+            return *this;
+        }
+
+        dynamic_bitset& reset() noexcept
+        {
+            std::fill(words.begin(), words.end(), word_type(0));
+            return *this;
+        }
+
+        dynamic_bitset& flip() noexcept
+        {
+            for (auto& w : words) w = ~w;
+            trim();
+            return *this;
+        }
+
+        size_type count() const noexcept { return Detail::popcount(words.data(), words.size()); }
+
+        bool any() const noexcept
+        {
+            return std::any_of(words.begin(), words.end(), [](word_type w) { return w != 0; });
+        }
+
+        bool none() const noexcept { return !any(); }
+        bool all() const noexcept { return count() == bits; }
+
+        // 第一个置位的位，没有则返回npos
+        size_type find_first() const noexcept { return scanFrom(0); }
+
+        // pos之后（不含pos）第一个置位的位，没有则返回npos
+        size_type find_next(size_type pos) const noexcept
+        {
+            if (pos == npos || ++pos >= bits) return npos;
+
+            const size_type w = pos / WordBits;
+            const word_type rest = words[w] >> (pos % WordBits);
+            if (rest != 0) return pos + static_cast<size_type>(std::countr_zero(rest));
+            return scanFrom(w + 1);
+        }
+
+        dynamic_bitset& operator&=(const dynamic_bitset& other) noexcept { return apply<Detail::Op::And>(other); }
+        dynamic_bitset& operator|=(const dynamic_bitset& other) noexcept { return apply<Detail::Op::Or>(other); }
+        dynamic_bitset& operator^=(const dynamic_bitset& other) noexcept { return apply<Detail::Op::Xor>(other); }
+
+        // *this &= ~other，不需要先构造~other
+        dynamic_bitset& andnot(const dynamic_bitset& other) noexcept { return apply<Detail::Op::AndNot>(other); }
+
+        friend dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset& b) noexcept { return std::move(a &= b); }
+        friend dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset& b) noexcept { return std::move(a |= b); }
+        friend dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset& b) noexcept { return std::move(a ^= b); }
+
+        friend bool operator==(const dynamic_bitset& a, const dynamic_bitset& b) noexcept
+        {
+            return a.bits == b.bits && a.words == b.words;
+        }
+
+    private:
+        static constexpr size_type wordsFor(size_type n) noexcept { return (n + WordBits - 1) / WordBits; }
+
+        // 清掉最后一个字中超出size()的位，count、any、==都依赖这一点
+        void trim() noexcept
+        {
+            if (bits % WordBits != 0) words.back() &= ~word_type(0) >> (WordBits - bits % WordBits);
+        }
+
+        size_type scanFrom(size_type w) const noexcept
+        {
+            for (; w < words.size(); ++w) {
+                if (words[w] != 0) return w * WordBits + static_cast<size_type>(std::countr_zero(words[w]));
+            }
+            return npos;
+        }
+
+        template<Detail::Op op>
+        dynamic_bitset& apply(const dynamic_bitset& other) noexcept
+        {
+            Detail::apply<op>(words.data(), other.words.data(), std::min(words.size(), other.words.size()));
+            return *this;
+        }
+
+        std::vector<word_type, CacheAlignedAllocator<word_type>> words;
+        size_type bits = 0;
+    };
+
+
+    // 四、item06中的features(w)
+    namespace Example
+    {
+        inline constexpr std::size_t FeatureCount = 8;
+
+        class Widget
+        {
+        public:
+            explicit Widget(std::uint8_t flags = 0b0101'0101) : flags(flags) {}
+
+            bool hasFeature(std::size_t k) const noexcept { return (flags >> k) & 1; }
+
+        private:
+            std::uint8_t flags;
+        };
+
+        // 与item06.cpp相同的接口：每次返回新的位集合，仍然要分配一次
+        inline dynamic_bitset features(const Widget& w)
+        {
+            dynamic_bitset bits(FeatureCount);
+            for (std::size_t k = 0; k < FeatureCount; ++k) bits.set(k, w.hasFeature(k));
+            return bits;
+        }
+
+        // 写入调用方提供的位集合：循环中反复调用时只在第一次分配
+        inline void features_into(const Widget& w, dynamic_bitset& bits)
+        {
+            bits.resize(FeatureCount);
+            for (std::size_t k = 0; k < FeatureCount; ++k) bits.set(k, w.hasFeature(k));
+        }
+
+        // 批量：一批Widget的第k个特征，第i位对应widgets[i]；之后可以在整批上做按字运算
+        inline void feature_column_into(std::span<const Widget> widgets, std::size_t k, dynamic_bitset& column)
+        {
+            column.resize(widgets.size());
+            column.reset();
+            dynamic_bitset::word_type* words = column.data();
+            for (std::size_t i = 0; i < widgets.size(); ++i) {
+                words[i / dynamic_bitset::WordBits] |= dynamic_bitset::word_type(widgets[i].hasFeature(k)) << (i % dynamic_bitset::WordBits);
+            }
+        }
+    }
+
+    inline void test()
+    {
+        using namespace Example;
+
+        Widget w;
+        auto highPriority = features(w)[5];         // bool，不是代理类，features(w)析构后仍然有效
+
+        dynamic_bitset bits;
+        for (int i = 0; i < 1000; ++i) {
+            features_into(w, bits);                 // 只在第一次分配
+            highPriority = bits[5];
+        }
+
+        std::vector<Widget> batch(1 << 16);
+        dynamic_bitset active, archived;
+        feature_column_into(batch, 0, active);
+        feature_column_into(batch, 1, archived);
+        active.andnot(archived);                    // 活跃且未归档
+        std::size_t n = active.count();
+
+        for (auto i = active.find_first(); i != dynamic_bitset::npos; i = active.find_next(i)) {
+            // 只访问置位的位
+        }
+
+        (void)highPriority; (void)n;
+    }
+}
+
+// 总结
+// * 返回代理类的operator[]让auto推导出意料之外的类型；让operator[]直接返回bool，auto就是安全的
+// * 位集合的价值在于按字批量运算：一条AVX2指令处理256个特征位
+// * 热循环中复用调用方的存储，而不是每次返回一个新容器
@@ -0,0 +1,278 @@
+/* 条款6 扩展 - 按Widget缓存features(w)的结果：FeatureCache */
+
+#pragma once
+
+#include "item05_flat_hash_map.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item06.cpp中每取一个特征都重新调用一次features(w)：
+        bool highPriority = static_cast<bool>(features(w)[5]);
+    每次都要完整地重新计算、重新分配一个vector<bool>，而只用到其中1位。
+    Widget不变时结果也不变，可以按Widget缓存下来：
+
+    * 键是Widget的身份id()，而不是地址：Widget析构后地址可能被新的Widget复用，id不会
+    * Widget每次修改都递增version()；缓存项记录计算时的版本，版本不一致即视为失效，下次访问时重新计算
+      也可以调用invalidate(w)显式丢弃
+    * flag(w, k)命中时在读锁下直接取出第k位，O(1)，不分配
+    * 按id分成多个分片，每个分片一把读写锁，多个线程同时读不同分片互不影响
+    * 计算在锁外进行：两个线程同时未命中同一个Widget时会各算一次，后写入的覆盖先写入的，结果相同
+    * 每个分片最多保存 capacity / 分片数 项，满了就整体清空该分片（最简单的淘汰策略）；
+      stats()返回命中、未命中、失效、清空次数，命中率明显下降时说明容量不够
+
+    Versioned是一个可选的基类，提供满足要求的id()、version()和touch()；
+    任何提供这两个成员函数的类型都可以作为键。
+*/
+
+namespace Item06_FeatureCache
+{
+    // 一、Widget的身份与版本
+    template<typename T>
+    concept VersionedObject = requires(const T& t) {
+        { t.id() } -> std::convertible_to<std::uint64_t>;
+        { t.version() } -> std::convertible_to<std::uint64_t>;
+    };
+
+    class Versioned
+    {
+    public:
+        Versioned() noexcept : identity(nextId()) {}
+
+        // 拷贝得到的是另一个对象，有自己的身份
+        Versioned(const Versioned&) noexcept : identity(nextId()) {}
+        Versioned& operator=(const Versioned&) noexcept
+        {
+            touch();
+            return *this;
+        }
+
+        std::uint64_t id() const noexcept { return identity; }
+        std::uint64_t version() const noexcept { return ver.load(std::memory_order_acquire); }
+
+        // 每次修改会影响特征的状态后调用
+        void touch() noexcept { ver.fetch_add(1, std::memory_order_release); }
+
+    protected:
+        ~Versioned() = default;
+
+    private:
+        static std::uint64_t nextId() noexcept
+        {
+            static std::atomic<std::uint64_t> counter{ 0 };
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        std::uint64_t identity;
+        std::atomic<std::uint64_t> ver{ 0 };
+    };
+
+
+    // 二、缓存
+    struct Stats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;           // 含失效
+        std::uint64_t stale = 0;            // 找到了，但版本已过期
+        std::uint64_t flushes = 0;          // 分片满后整体清空的次数
+        std::size_t entries = 0;
+
+        double hitRate() const noexcept
+        {
+            const auto total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+        }
+    };
+
+    template<VersionedObject T, typename Compute>
+    class FeatureCache
+    {
+    public:
+        using features_type = std::remove_cvref_t<std::invoke_result_t<Compute&, const T&>>;
+
+        static constexpr std::size_t ShardCount = 16;
+
+        explicit FeatureCache(Compute compute, std::size_t capacity = 64 * 1024)
+            : compute(std::move(compute)), shardCapacity(std::max<std::size_t>(1, capacity / ShardCount))
+        {
+        }
+
+        FeatureCache(const FeatureCache&) = delete;
+        FeatureCache& operator=(const FeatureCache&) = delete;
+
+        // 第k个特征：命中时O(1)
+        bool flag(const T& w, std::size_t k)
+        {
+            return lookup(w, [k](const features_type& f) { return static_cast<bool>(f[k]); });
+        }
+
+        // 整个特征集合的拷贝
+        features_type features(const T& w)
+        {
+            return lookup(w, [](const features_type& f) { return f; });
+        }
+
+        void invalidate(const T& w)
+        {
+            Shard& shard = shardOf(w.id());
+            std::unique_lock lock(shard.mutex);
+            shard.entries.erase(w.id());
+        }
+
+        void clear()
+        {
+            for (Shard& shard : shards) {
+                std::unique_lock lock(shard.mutex);
+                shard.entries.clear();
+            }
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            for (const Shard& shard : shards) {
+                s.hits += shard.hits.load(std::memory_order_relaxed);
+                s.misses += shard.misses.load(std::memory_order_relaxed);
+                s.stale += shard.stale.load(std::memory_order_relaxed);
+                s.flushes += shard.flushes.load(std::memory_order_relaxed);
+                std::shared_lock lock(shard.mutex);
+                s.entries += shard.entries.size();
+            }
+            return s;
+        }
+
+    private:
+        struct Entry
+        {
+            std::uint64_t version;
+            features_type features;
+        };
+
+        // 各分片独占缓存行，计数器和锁不会在分片之间伪共享
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex mutex;
+            Item05_FlatHashMap::flat_hash_map<std::uint64_t, Entry> entries;
+            std::atomic<std::uint64_t> hits{ 0 };
+            std::atomic<std::uint64_t> misses{ 0 };
+            std::atomic<std::uint64_t> stale{ 0 };
+            std::atomic<std::uint64_t> flushes{ 0 };
+        };
+
+        Shard& shardOf(std::uint64_t id) noexcept { return shards[id % ShardCount]; }
+
+        template<typename Read>
+        auto lookup(const T& w, Read read) -> std::invoke_result_t<Read&, const features_type&>
+        {
+            const std::uint64_t id = w.id();
+            const std::uint64_t version = w.version();      // 在计算之前读取：计算期间被修改的话，下次访问会重新计算
+            Shard& shard = shardOf(id);
+
+            {
+                std::shared_lock lock(shard.mutex);
+                auto it = shard.entries.find(id);
+                if (it != shard.entries.end()) {
+                    if (it->second.version == version) {
+                        shard.hits.fetch_add(1, std::memory_order_relaxed);
+                        return read(it->second.features);
+                    }
+                    shard.stale.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+            features_type computed = std::invoke(compute, w);
+            auto result = read(computed);
+
+            std::unique_lock lock(shard.mutex);
+            auto it = shard.entries.find(id);
+            if (it != shard.entries.end()) {
+                if (it->second.version <= version) it->second = Entry{ version, std::move(computed) };
+            }
+            else {
+                if (shard.entries.size() >= shardCapacity) {
+                    shard.entries.clear();
+                    shard.flushes.fetch_add(1, std::memory_order_relaxed);
+                }
+                shard.entries.try_emplace(id, Entry{ version, std::move(computed) });
+            }
+            return result;
+        }
+
+        Compute compute;
+        std::size_t shardCapacity;
+        Shard shards[ShardCount];
+    };
+
+
+    // T无法从计算函数推导，由调用方显式给出：auto cache = makeFeatureCache<Widget>(compute);
+    template<VersionedObject T, typename Compute>
+    FeatureCache<T, Compute> makeFeatureCache(Compute compute, std::size_t capacity = 64 * 1024)
+    {
+        return FeatureCache<T, Compute>(std::move(compute), capacity);
+    }
+
+
+    // 三、item06中的Widget
+    namespace Example
+    {
+        class Widget : public Versioned
+        {
+        public:
+            explicit Widget(int priority = 0) : priority(priority) {}
+
+            int getPriority() const noexcept { return priority; }
+
+            void setPriority(int p) noexcept
+            {
+                priority = p;
+                touch();
+            }
+
+        private:
+            int priority;
+        };
+
+        // 与item06.cpp相同：每次调用都重新计算、重新分配
+        inline std::vector<bool> features(const Widget& w)
+        {
+            std::vector<bool> f(64);
+            for (std::size_t k = 0; k < f.size(); ++k) f[k] = ((w.getPriority() >> (k % 16)) ^ static_cast<int>(k)) & 1;
+            return f;
+        }
+    }
+
+    inline void test()
+    {
+        using Example::Widget;
+
+        auto cache = makeFeatureCache<Widget>([](const Widget& w) { return Example::features(w); });
+
+        Widget w(5);
+        bool highPriority = cache.flag(w, 5);      // 未命中：计算并缓存
+        highPriority = cache.flag(w, 5);           // 命中：O(1)，不分配
+
+        w.setPriority(7);                          // 版本+1
+        highPriority = cache.flag(w, 5);           // 版本不一致：重新计算
+
+        cache.invalidate(w);                       // 显式丢弃
+        Stats s = cache.stats();                   // hits 1, misses 2, stale 1
+
+        (void)highPriority; (void)s;
+    }
+}
+
+// 总结
+// * features(w)[5] 在循环里反复出现时，开销来自重复计算整个集合，而不是取出那一位
+// * 缓存的键要能区分"同一个对象"和"同一个地址"，失效要能感知对象被修改：用id + version
+// * 先测量命中率，再决定容量
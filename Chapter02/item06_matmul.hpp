@@ -0,0 +1,258 @@
+/* 条款6 扩展 - 矩阵乘法：分块、打包、寄存器分块的微内核、多线程 */
+
+#pragma once
+
+#include "item05_dwim.hpp"                          // ThreadPool
+#include "item06_matrix.hpp"                        // BasicMatrix
+#include "../Chapter01/item01_fixed_search.hpp"     // EMCP_FIXED_SEARCH_SIMD、hasAvx2()
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/*
+    item06_matrix.hpp中的表达式模板只融合逐元素运算。矩阵乘法 C = A * B 的每个元素依赖A的一行和B的一列，
+    朴素的三重循环（i, j, k）沿B的列跨步访问，n稍大时几乎每次读B都是缓存未命中，只能跑到峰值的零头。
+
+    multiply(a, b, c) 按GotoBLAS/BLIS的结构组织：
+        for jc 按NC列切分B、C                        B的一块（KC x NC）放进L3
+          for pc 按KC切分公共维k
+            打包B的 KC x NC 块：每NR列一条，按k连续存放
+            for ic 按MC行切分A、C（多个线程各取一块）    A的一块（MC x KC）放进L2
+              打包A的 MC x KC 块：每MR行一条，按k连续存放
+              for jr、ir：微内核计算C的一个 MR x NR 小块   B的一条（KC x NR）留在L1
+    * 微内核（double，AVX2 + FMA）：MR x NR = 6 x 8，12个ymm累加器常驻寄存器，
+      每个k读一次A的6个元素（广播）和B的8个元素，做12次FMA；不支持时使用标量微内核（结构相同，编译器自动向量化）
+    * 打包让微内核只做连续、对齐无关的读取；不足MR、NR的边缘补0，边缘块先算到临时缓冲区再加回C
+    * 线程：ic块分给Item05_Dwim::ThreadPool（与dwim共用），每个线程各自打包自己的A块；B块由各线程分条打包后共享
+    * threads为0时使用全部硬件线程；小矩阵自动缩小MC，让每个线程至少分到两块
+
+    c会被调整为 a.rows() x b.cols() 并覆盖；c不能与a、b是同一个对象。维度不一致时抛出std::invalid_argument。
+*/
+
+namespace Item06_MatMul
+{
+    using Item06_Matrix::BasicMatrix;
+    using Item06_Matrix::Matrix;
+
+    // 一、分块参数
+    inline constexpr std::size_t MR = 6;
+    inline constexpr std::size_t NR = 8;
+    inline constexpr std::size_t KC = 256;          // B的一条：256 x 8 x 8字节 = 16KB，L1
+    inline constexpr std::size_t MC = 96;           // A的一块：96 x 256 x 8字节 = 192KB，L2
+    inline constexpr std::size_t NC = 2048;         // B的一块：256 x 2048 x 8字节 = 4MB，L3
+
+    inline bool hasFma() noexcept
+    {
+#if defined(__FMA__)
+        return true;
+#elif EMCP_FIXED_SEARCH_SIMD
+        static const bool supported = __builtin_cpu_supports("fma");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+
+    // 二、打包
+    namespace Detail
+    {
+        // A的 mc x kc 块 -> 每MR行一条，条内按k排列：buf[(条 * kc + k) * MR + r]
+        template<typename T>
+        void packA(const T* a, std::size_t lda, std::size_t mc, std::size_t kc, T* buf)
+        {
+            for (std::size_t ir = 0; ir < mc; ir += MR) {
+                const std::size_t rows = std::min(MR, mc - ir);
+                for (std::size_t k = 0; k < kc; ++k) {
+                    for (std::size_t r = 0; r < MR; ++r) *buf++ = r < rows ? a[(ir + r) * lda + k] : T();
+                }
+            }
+        }
+
+        // B的 kc x nc 块中的第jr列起的一条 -> buf[k * NR + j]
+        template<typename T>
+        void packBPanel(const T* b, std::size_t ldb, std::size_t kc, std::size_t cols, T* buf)
+        {
+            for (std::size_t k = 0; k < kc; ++k) {
+                const T* row = b + k * ldb;
+                for (std::size_t j = 0; j < NR; ++j) *buf++ = j < cols ? row[j] : T();
+            }
+        }
+
+
+        // 三、微内核：C[MR x NR] += A条 * B条
+        template<typename T>
+        void kernelScalar(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc)
+        {
+            T acc[MR][NR] = {};
+            for (std::size_t k = 0; k < kc; ++k, a += MR, b += NR) {
+                for (std::size_t r = 0; r < MR; ++r) {
+                    for (std::size_t j = 0; j < NR; ++j) acc[r][j] += a[r] * b[j];
+                }
+            }
+            for (std::size_t r = 0; r < MR; ++r) {
+                for (std::size_t j = 0; j < NR; ++j) c[r * ldc + j] += acc[r][j];
+            }
+        }
+
+#if EMCP_FIXED_SEARCH_SIMD
+        #pragma GCC push_options
+        #pragma GCC target("avx2,fma")
+        namespace Avx2
+        {
+            inline void kernel6x8(std::size_t kc, const double* a, const double* b, double* c, std::size_t ldc)
+            {
+                __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+                __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+                __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+                __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+                __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+                __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+                for (std::size_t k = 0; k < kc; ++k, a += MR, b += NR) {
+                    const __m256d b0 = _mm256_loadu_pd(b);
+                    const __m256d b1 = _mm256_loadu_pd(b + 4);
+                    __m256d ar;
+                    ar = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ar, b0, c00); c01 = _mm256_fmadd_pd(ar, b1, c01);
+                    ar = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ar, b0, c10); c11 = _mm256_fmadd_pd(ar, b1, c11);
+                    ar = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ar, b0, c20); c21 = _mm256_fmadd_pd(ar, b1, c21);
+                    ar = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ar, b0, c30); c31 = _mm256_fmadd_pd(ar, b1, c31);
+                    ar = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ar, b0, c40); c41 = _mm256_fmadd_pd(ar, b1, c41);
+                    ar = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ar, b0, c50); c51 = _mm256_fmadd_pd(ar, b1, c51);
+                }
+
+                auto store = [ldc, c](std::size_t r, __m256d lo, __m256d hi) {
+                    double* row = c + r * ldc;
+                    _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), lo));
+                    _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), hi));
+                };
+                store(0, c00, c01);
+                store(1, c10, c11);
+                store(2, c20, c21);
+                store(3, c30, c31);
+                store(4, c40, c41);
+                store(5, c50, c51);
+            }
+        }
+        #pragma GCC pop_options
+#endif
+
+        template<typename T>
+        using Kernel = void (*)(std::size_t, const T*, const T*, T*, std::size_t);
+
+        template<typename T>
+        Kernel<T> selectKernel()
+        {
+#if EMCP_FIXED_SEARCH_SIMD
+            if constexpr (std::is_same_v<T, double>) {
+                if (Item01_FixedSearch::hasAvx2() && hasFma()) return &Avx2::kernel6x8;
+            }
+#endif
+            return &kernelScalar<T>;
+        }
+
+        // 计算C中以c为左上角的 mc x nc 区域：完整的块直接累加到C，边缘块经过临时缓冲区
+        template<typename T>
+        void macroKernel(Kernel<T> kernel, std::size_t mc, std::size_t nc, std::size_t kc,
+                         const T* packedA, const T* packedB, T* c, std::size_t ldc)
+        {
+            for (std::size_t jr = 0; jr < nc; jr += NR) {
+                const std::size_t cols = std::min(NR, nc - jr);
+                for (std::size_t ir = 0; ir < mc; ir += MR) {
+                    const std::size_t rows = std::min(MR, mc - ir);
+                    const T* a = packedA + ir * kc;
+                    const T* b = packedB + jr * kc;
+                    T* dst = c + ir * ldc + jr;
+
+                    if (rows == MR && cols == NR) {
+                        kernel(kc, a, b, dst, ldc);
+                    }
+                    else {
+                        T edge[MR * NR] = {};
+                        kernel(kc, a, b, edge, NR);
+                        for (std::size_t r = 0; r < rows; ++r) {
+                            for (std::size_t j = 0; j < cols; ++j) dst[r * ldc + j] += edge[r * NR + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+    // 四、对外接口
+    template<typename T>
+    void multiply(const BasicMatrix<T>& a, const BasicMatrix<T>& b, BasicMatrix<T>& c, unsigned threads = 0)
+    {
+        if (a.cols() != b.rows()) throw std::invalid_argument("multiply: a.cols() != b.rows()");
+        if (&c == &a || &c == &b) throw std::invalid_argument("multiply: c不能与a、b是同一个矩阵");
+
+        const std::size_t m = a.rows(), n = b.cols(), k = a.cols();
+        if (c.rows() != m || c.cols() != n) c = BasicMatrix<T>(m, n);
+        else std::fill(c.data(), c.data() + c.size(), T());
+        if (m == 0 || n == 0 || k == 0) return;
+
+        auto& pool = Item05_Dwim::ThreadPool::instance();
+        const std::size_t workers = threads == 0 ? pool.size() : std::min<std::size_t>(threads, pool.size());
+        const auto kernel = Detail::selectKernel<T>();
+
+        // 多线程时让每个线程至少分到两个ic块
+        std::size_t mc = MC;
+        if (workers > 1) mc = std::clamp((m / (2 * workers) + MR - 1) / MR * MR, MR, MC);
+        const std::size_t icBlocks = (m + mc - 1) / mc;
+
+        std::vector<T> packedB((std::min(NC, n) + NR - 1) / NR * NR * std::min(KC, k));
+
+        for (std::size_t jc = 0; jc < n; jc += NC) {
+            const std::size_t nc = std::min(NC, n - jc);
+            const std::size_t panels = (nc + NR - 1) / NR;
+
+            for (std::size_t pc = 0; pc < k; pc += KC) {
+                const std::size_t kc = std::min(KC, k - pc);
+                const T* bBlock = b.data() + pc * n + jc;
+
+                pool.parallelFor(panels, workers, [&](std::size_t p) {
+                    Detail::packBPanel(bBlock + p * NR, n, kc, std::min(NR, nc - p * NR), packedB.data() + p * NR * kc);
+                });
+
+                pool.parallelFor(icBlocks, workers, [&](std::size_t blk) {
+                    const std::size_t ic = blk * mc;
+                    const std::size_t rows = std::min(mc, m - ic);
+
+                    thread_local std::vector<T> packedA;
+                    packedA.resize((MC + MR - 1) / MR * MR * KC);
+                    Detail::packA(a.data() + ic * k + pc, k, rows, kc, packedA.data());
+
+                    Detail::macroKernel(kernel, rows, nc, kc, packedA.data(), packedB.data(), c.data() + ic * n + jc, n);
+                });
+            }
+        }
+    }
+
+    template<typename T>
+    BasicMatrix<T> multiply(const BasicMatrix<T>& a, const BasicMatrix<T>& b, unsigned threads = 0)
+    {
+        BasicMatrix<T> c;
+        multiply(a, b, c, threads);
+        return c;
+    }
+
+    inline void test()
+    {
+        const std::size_t n = 512;
+        Matrix a(n, n, 1.0), b(n, n, 2.0);
+
+        Matrix c = multiply(a, b);              // 全部硬件线程
+        multiply(a, b, c, 1);                   // 单线程，复用c的存储
+
+        Matrix d = multiply(a, b) + c;          // 乘积是普通Matrix，可以继续参与表达式模板
+    }
+}
+
+// 总结
+// * 矩阵乘法的瓶颈是访存而不是乘加：分块让每一级缓存中的数据被重复使用，打包让内层循环只做连续读取
+// * 微内核把C的一个小块留在寄存器中，每次读A、B都对应多次FMA
+// * 多线程按C的行块切分，各线程写不相交的区域，不需要同步
@@ -0,0 +1,306 @@
+/* 条款6 扩展 - 表达式模板：Matrix sum = m1 + m2 + m3 + m4 只做一次循环 */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item06.cpp第二节提到：
+        Matrix sum = m1 + m2 + m3 + m4;
+    如果operator+直接返回Matrix，这一行会产生3个临时Matrix，把所有元素读写4遍。
+    让operator+返回一个代理（这里是Binary<std::plus<>, L, R>），只记录"要做什么"，
+    等赋值给Matrix时再用一个循环逐元素求值：
+
+        sum[i] = ((m1[i] + m2[i]) + m3[i]) + m4[i];
+
+    没有临时矩阵，每个元素只读写一次，循环体是连续内存上的纯算术，编译器可以向量化。
+
+    代价正是条款6警告的：
+        auto sum = m1 + m2 + m3 + m4;   // sum是Binary<...>，不是Matrix！
+    代理保存着m1~m4的引用，m1~m4修改或析构后，sum的值随之改变或悬空。这里的处理：
+    * 具名的Matrix（左值）按引用保存；临时Matrix（右值）移动进代理按值保存，代理不会引用已析构的临时对象
+    * 代理只能以临时对象的身份使用：用左值代理构造Matrix、或继续参与运算时编译失败（static_assert），
+      提示改用显式类型初始化 Matrix sum = ...，或显式调用 sum.eval()
+    * is_expression_v<T>：判断T是否为表达式代理，泛型代码可以用它拒绝或求值代理
+      static_assert(!Item06_Matrix::is_expression_v<decltype(sum)>);
+
+    支持的运算：+、-（二元和一元）、与标量相乘；矩阵乘法不是逐元素运算，不在这里融合。
+    维度不一致时抛出std::invalid_argument。
+*/
+
+namespace Item06_Matrix
+{
+    template<typename T>
+    class BasicMatrix;
+
+    using Matrix = BasicMatrix<double>;
+
+    // 一、类型判断
+    namespace Detail
+    {
+        struct ExpressionBase {};           // 所有代理的基类，只用于识别
+
+        template<typename T>
+        struct IsMatrix : std::false_type {};
+
+        template<typename T>
+        struct IsMatrix<BasicMatrix<T>> : std::true_type {};
+    }
+
+    template<typename T>
+    inline constexpr bool is_expression_v = std::is_base_of_v<Detail::ExpressionBase, std::remove_cvref_t<T>>;
+
+    template<typename T>
+    inline constexpr bool is_matrix_v = Detail::IsMatrix<std::remove_cvref_t<T>>::value;
+
+    template<typename T>
+    concept MatrixOperand = is_expression_v<T> || is_matrix_v<T>;
+
+    namespace Detail
+    {
+        // 代理中如何保存操作数：具名Matrix保存引用，其余（临时Matrix、子表达式）按值保存
+        template<typename A>
+        using Stored = std::conditional_t<is_matrix_v<A> && std::is_lvalue_reference_v<A>,
+                                          const std::remove_cvref_t<A>&, std::remove_cvref_t<A>>;
+
+        // 左值代理（auto保存下来的具名代理）不能再参与运算或构造Matrix
+        template<typename A>
+        constexpr void requireTemporary()
+        {
+            static_assert(!(is_expression_v<A> && std::is_lvalue_reference_v<A>),
+                          "表达式代理被auto保存成了具名变量，它引用的矩阵可能已经修改或析构："
+                          "请写成 Matrix x = ...（显式类型初始化），或显式调用 x.eval()");
+        }
+
+        template<typename L, typename R>
+        void checkShape(const L& l, const R& r)
+        {
+            if (l.rows() != r.rows() || l.cols() != r.cols()) throw std::invalid_argument("Matrix: 维度不一致");
+        }
+    }
+
+
+    // 二、代理
+    template<typename Op, typename L, typename R>
+    class Binary : Detail::ExpressionBase
+    {
+    public:
+        using value_type = std::common_type_t<typename std::remove_cvref_t<L>::value_type,
+                                              typename std::remove_cvref_t<R>::value_type>;
+
+        template<typename LArg, typename RArg>
+        Binary(LArg&& l, RArg&& r) : l(std::forward<LArg>(l)), r(std::forward<RArg>(r))
+        {
+            Detail::checkShape(this->l, this->r);
+        }
+
+        std::size_t rows() const noexcept { return l.rows(); }
+        std::size_t cols() const noexcept { return l.cols(); }
+
+        value_type operator[](std::size_t i) const { return Op{}(l[i], r[i]); }
+
+        BasicMatrix<value_type> eval() const { return BasicMatrix<value_type>(*this, 0); }
+
+    private:
+        L l;
+        R r;
+    };
+
+    // 一元运算：取负、乘以标量
+    template<typename Op, typename A>
+    class Unary : Detail::ExpressionBase
+    {
+    public:
+        using value_type = typename std::remove_cvref_t<A>::value_type;
+
+        template<typename AArg>
+        Unary(AArg&& a, Op op) : a(std::forward<AArg>(a)), op(op) {}
+
+        std::size_t rows() const noexcept { return a.rows(); }
+        std::size_t cols() const noexcept { return a.cols(); }
+
+        value_type operator[](std::size_t i) const { return op(a[i]); }
+
+        BasicMatrix<value_type> eval() const { return BasicMatrix<value_type>(*this, 0); }
+
+    private:
+        A a;
+        Op op;
+    };
+
+    namespace Detail
+    {
+        template<typename T>
+        struct Scale
+        {
+            T factor;
+            T operator()(T x) const noexcept { return factor * x; }
+        };
+
+        struct Negate
+        {
+            template<typename T>
+            T operator()(T x) const noexcept { return -x; }
+        };
+    }
+
+
+    // 三、矩阵：按行存放在连续内存中
+    template<typename T>
+    class BasicMatrix
+    {
+    public:
+        using value_type = T;
+
+        BasicMatrix() = default;
+        BasicMatrix(std::size_t rows, std::size_t cols, T value = T()) : r(rows), c(cols), elems(rows * cols, value) {}
+
+        // 从临时代理构造：Matrix sum = m1 + m2 + m3 + m4;
+        template<typename E>
+            requires is_expression_v<E>
+        BasicMatrix(E&& e) : BasicMatrix((Detail::requireTemporary<E>(), e), 0) {}
+
+        template<typename E>
+            requires is_expression_v<E>
+        BasicMatrix& operator=(E&& e)
+        {
+            Detail::requireTemporary<E>();
+            if (r != e.rows() || c != e.cols()) {
+                // 维度变化时先求值到新矩阵，代理可能引用着*this
+                *this = BasicMatrix(e, 0);
+            }
+            else {
+                assign(e);
+            }
+            return *this;
+        }
+
+        // 逐元素运算，this[i]只依赖各操作数的第i个元素，所以右边引用*this也是安全的
+        template<typename E>
+            requires MatrixOperand<E>
+        BasicMatrix& operator+=(E&& e) { return *this = *this + std::forward<E>(e); }
+
+        template<typename E>
+            requires MatrixOperand<E>
+        BasicMatrix& operator-=(E&& e) { return *this = *this - std::forward<E>(e); }
+
+        BasicMatrix& operator*=(T factor) { return *this = *this * factor; }
+
+        std::size_t rows() const noexcept { return r; }
+        std::size_t cols() const noexcept { return c; }
+        std::size_t size() const noexcept { return elems.size(); }
+
+        T& operator()(std::size_t row, std::size_t col) noexcept { return elems[row * c + col]; }
+        const T& operator()(std::size_t row, std::size_t col) const noexcept { return elems[row * c + col]; }
+
+        // 按行展开后的第i个元素，与代理的operator[]一致
+        T& operator[](std::size_t i) noexcept { return elems[i]; }
+        const T& operator[](std::size_t i) const noexcept { return elems[i]; }
+
+        T* data() noexcept { return elems.data(); }
+        const T* data() const noexcept { return elems.data(); }
+
+        friend bool operator==(const BasicMatrix&, const BasicMatrix&) = default;
+
+    private:
+        template<typename, typename, typename> friend class Binary;
+        template<typename, typename> friend class Unary;
+
+        // 求值：第二个参数只用于区分重载
+        template<typename E>
+            requires is_expression_v<E>
+        BasicMatrix(const E& e, int) : r(e.rows()), c(e.cols()), elems(e.rows() * e.cols())
+        {
+            assign(e);
+        }
+
+        // 融合后的唯一一个循环：各次迭代互不依赖，告诉编译器放心向量化
+        template<typename E>
+        void assign(const E& e)
+        {
+            T* out = elems.data();
+            const std::size_t n = elems.size();
+#if defined(__GNUC__) && !defined(__clang__)
+            #pragma GCC ivdep
+#elif defined(__clang__)
+            #pragma clang loop vectorize(assume_safety)
+#endif
+            for (std::size_t i = 0; i < n; ++i) out[i] = e[i];
+        }
+
+        std::size_t r = 0;
+        std::size_t c = 0;
+        std::vector<T> elems;
+    };
+
+
+    // 四、运算符：只构造代理，不做计算
+    template<typename L, typename R>
+        requires MatrixOperand<L> && MatrixOperand<R>
+    auto operator+(L&& l, R&& r)
+    {
+        Detail::requireTemporary<L>();
+        Detail::requireTemporary<R>();
+        return Binary<std::plus<>, Detail::Stored<L>, Detail::Stored<R>>(std::forward<L>(l), std::forward<R>(r));
+    }
+
+    template<typename L, typename R>
+        requires MatrixOperand<L> && MatrixOperand<R>
+    auto operator-(L&& l, R&& r)
+    {
+        Detail::requireTemporary<L>();
+        Detail::requireTemporary<R>();
+        return Binary<std::minus<>, Detail::Stored<L>, Detail::Stored<R>>(std::forward<L>(l), std::forward<R>(r));
+    }
+
+    template<typename A>
+        requires MatrixOperand<A>
+    auto operator-(A&& a)
+    {
+        Detail::requireTemporary<A>();
+        return Unary<Detail::Negate, Detail::Stored<A>>(std::forward<A>(a), Detail::Negate{});
+    }
+
+    template<typename A>
+        requires MatrixOperand<A>
+    auto operator*(A&& a, typename std::remove_cvref_t<A>::value_type factor)
+    {
+        Detail::requireTemporary<A>();
+        using T = typename std::remove_cvref_t<A>::value_type;
+        return Unary<Detail::Scale<T>, Detail::Stored<A>>(std::forward<A>(a), Detail::Scale<T>{ factor });
+    }
+
+    template<typename A>
+        requires MatrixOperand<A>
+    auto operator*(typename std::remove_cvref_t<A>::value_type factor, A&& a)
+    {
+        return std::forward<A>(a) * factor;
+    }
+
+    inline void test()
+    {
+        Matrix m1(4, 4, 1.0), m2(4, 4, 2.0), m3(4, 4, 3.0), m4(4, 4, 4.0);
+
+        Matrix sum = m1 + m2 + m3 + m4;         // 一个循环，没有临时矩阵
+        sum = 0.5 * (sum - m1) + m2;            // 赋值给已有矩阵，不分配
+
+        auto proxy = m1 + m2;                   // Binary<std::plus<>, const Matrix&, const Matrix&>
+        static_assert(is_expression_v<decltype(proxy)>);
+        Matrix fromProxy = proxy.eval();        // 显式求值，OK
+        // Matrix bad = proxy;                  // 编译错误：具名代理，请使用显式类型初始化或eval()
+        // Matrix bad2 = proxy + m3;            // 编译错误：同上
+
+        auto safe = Matrix(4, 4, 1.0) + m2;     // 临时Matrix被移动进代理，不会悬空
+        Matrix fromSafe = safe.eval();
+    }
+}
+
+// 总结
+// * 表达式模板让 m1 + m2 + m3 + m4 在赋值时融合成一个循环：没有临时对象，每个元素只读写一次
+// * 它依靠的正是代理类，auto会把代理本身保存下来；用显式类型初始化（Matrix sum = ...）或eval()得到真正的结果
+// * 让代理只能以临时对象的身份使用，把悬空的可能性变成编译错误
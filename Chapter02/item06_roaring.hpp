@@ -0,0 +1,605 @@
+/* 条款6 扩展 - 压缩位图索引：按特征分列的Roaring位图 */
+
+#pragma once
+
+#include "item06_dynamic_bitset.hpp"        // CacheAlignedAllocator、按字运算与popcount
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/*
+    features(w)给出单个Widget的特征；实际的查询是反过来的：
+        "哪些Widget有特征5、没有特征2？"
+    为每个特征建一列位图（第i位表示第i个Widget），查询就是两列之间的 AND NOT。
+    未压缩的位图（dynamic_bitset）在1000万个Widget上每列1.25MB，稀疏的特征也一样大。
+
+    Roaring位图把32位的Widget编号按高16位分块，每块（最多65536个值）按密度选用一种容器：
+    * Array   有序的uint16数组，元素不超过4096个（每个2字节，4096个时正好等于位图的8KB）
+    * Bitmap  1024个64位字（8KB），元素多于4096个时使用
+    * Run     (起点, 长度-1) 的有序区间，连续成段的特征（如按创建时间聚集）用它最省；由run_optimize()选择
+
+    运算按容器类型组合选择实现：
+    * Array 与 Array：有序归并
+    * Array 与 其它：对数组中的每个值查另一边（AND、ANDNOT的左边为Array时，结果一定不多于数组）
+    * 其它组合：两边展开成1024个字（Bitmap直接使用），用AVX2按字运算，结果元素不超过4096个时再转回Array
+    * and_cardinality等只计数不构造结果：位图与位图用"运算 + popcount"融合的AVX2循环，
+      区间与位图只数区间覆盖的字，区间与区间直接求重叠长度
+
+    编号需要按递增顺序add()时最快（追加到最后一个容器的末尾）；乱序同样正确，只是要在数组中间插入。
+*/
+
+namespace Item06_Roaring
+{
+    // 一、容器
+    namespace Detail
+    {
+        using Word = std::uint64_t;
+        using Op = Item06_DynamicBitset::Detail::Op;
+        using Words = std::vector<Word, Item06_DynamicBitset::CacheAlignedAllocator<Word>>;
+
+        inline constexpr std::size_t BitmapWords = 1024;
+        inline constexpr std::size_t ArrayMax = 4096;
+
+        // 覆盖 [start, start + length]
+        struct Run
+        {
+            std::uint16_t start;
+            std::uint16_t length;
+        };
+
+        struct Container
+        {
+            enum class Kind : std::uint8_t { Array, Bitmap, Run };
+
+            Kind kind = Kind::Array;
+            std::uint32_t card = 0;
+            std::vector<std::uint16_t> array;
+            Words bitmap;
+            std::vector<Run> runs;
+
+            bool contains(std::uint16_t v) const noexcept
+            {
+                switch (kind) {
+                case Kind::Array:
+                    return std::binary_search(array.begin(), array.end(), v);
+                case Kind::Bitmap:
+                    return (bitmap[v / 64] >> (v % 64)) & 1;
+                default: {
+                    // 最后一个起点不大于v的区间
+                    auto it = std::upper_bound(runs.begin(), runs.end(), v, [](std::uint16_t x, const Run& r) { return x < r.start; });
+                    return it != runs.begin() && v <= std::prev(it)->start + std::prev(it)->length;
+                }
+                }
+            }
+
+            void add(std::uint16_t v)
+            {
+                if (kind == Kind::Run) toBitmap();
+
+                if (kind == Kind::Array) {
+                    if (array.empty() || array.back() < v) {
+                        array.push_back(v);                 // 递增添加：追加
+                    }
+                    else {
+                        auto it = std::lower_bound(array.begin(), array.end(), v);
+                        if (*it == v) return;
+                        array.insert(it, v);
+                    }
+                    if (++card > ArrayMax) toBitmap();
+                }
+                else {
+                    Word& w = bitmap[v / 64];
+                    const Word bit = Word(1) << (v % 64);
+                    card += (w & bit) == 0;
+                    w |= bit;
+                }
+            }
+
+            // 展开成1024个字；out必须按32字节对齐
+            void toWords(Word* out) const noexcept
+            {
+                if (kind == Kind::Bitmap) {
+                    std::copy(bitmap.begin(), bitmap.end(), out);
+                    return;
+                }
+                std::fill(out, out + BitmapWords, Word(0));
+                if (kind == Kind::Array) {
+                    for (std::uint16_t v : array) out[v / 64] |= Word(1) << (v % 64);
+                }
+                else {
+                    for (const Run& r : runs) setRange(out, r.start, std::uint32_t(r.start) + r.length + 1);
+                }
+            }
+
+            const Word* words(Word* scratch) const noexcept
+            {
+                if (kind == Kind::Bitmap) return bitmap.data();
+                toWords(scratch);
+                return scratch;
+            }
+
+            void toBitmap()
+            {
+                Words w(BitmapWords);
+                toWords(w.data());
+                bitmap = std::move(w);
+                array = {};
+                runs = {};
+                kind = Kind::Bitmap;
+            }
+
+            // 由按字运算的结果构造：元素不超过ArrayMax时转成Array
+            static Container fromWords(Words&& w, std::uint32_t card)
+            {
+                Container c;
+                c.card = card;
+                if (card > ArrayMax) {
+                    c.kind = Kind::Bitmap;
+                    c.bitmap = std::move(w);
+                    return c;
+                }
+                c.array.reserve(card);
+                for (std::size_t i = 0; i < BitmapWords; ++i) {
+                    for (Word bits = w[i]; bits != 0; bits &= bits - 1) {
+                        c.array.push_back(static_cast<std::uint16_t>(i * 64 + std::countr_zero(bits)));
+                    }
+                }
+                return c;
+            }
+
+            static Container fromArray(std::vector<std::uint16_t>&& values)
+            {
+                Container c;
+                c.card = static_cast<std::uint32_t>(values.size());
+                if (values.size() > ArrayMax) {
+                    c.array = std::move(values);
+                    c.toBitmap();
+                }
+                else {
+                    c.array = std::move(values);
+                }
+                return c;
+            }
+
+            std::size_t bytes() const noexcept
+            {
+                switch (kind) {
+                case Kind::Array: return array.size() * sizeof(std::uint16_t);
+                case Kind::Bitmap: return BitmapWords * sizeof(Word);
+                default: return runs.size() * sizeof(Run);
+                }
+            }
+
+            // 区间数更少时转成Run，返回是否发生了转换
+            bool runOptimize()
+            {
+                if (kind == Kind::Run) return false;
+
+                alignas(64) static thread_local Word scratch[BitmapWords];
+                const Word* w = words(scratch);
+                std::size_t runCount = 0;
+                Word carry = 0;         // 前一个字的最高位
+                for (std::size_t i = 0; i < BitmapWords; ++i) {
+                    // 区间的起点：本位为1且前一位为0
+                    runCount += static_cast<std::size_t>(std::popcount(w[i] & ~((w[i] << 1) | carry)));
+                    carry = w[i] >> 63;
+                }
+                if (runCount * sizeof(Run) >= bytes()) return false;
+
+                std::vector<Run> result;
+                result.reserve(runCount);
+                std::uint32_t v = 0;
+                while (v < BitmapWords * 64) {
+                    const std::uint32_t start = nextBit(w, v, true);
+                    if (start >= BitmapWords * 64) break;
+                    const std::uint32_t end = nextBit(w, start, false);
+                    result.push_back({ static_cast<std::uint16_t>(start), static_cast<std::uint16_t>(end - start - 1) });
+                    v = end;
+                }
+                runs = std::move(result);
+                array = {};
+                bitmap = {};
+                kind = Kind::Run;
+                return true;
+            }
+
+            template<typename F>
+            void forEach(std::uint32_t high, F& fn) const
+            {
+                switch (kind) {
+                case Kind::Array:
+                    for (std::uint16_t v : array) fn(high | v);
+                    break;
+                case Kind::Bitmap:
+                    for (std::size_t i = 0; i < BitmapWords; ++i) {
+                        for (Word bits = bitmap[i]; bits != 0; bits &= bits - 1) {
+                            fn(high | static_cast<std::uint32_t>(i * 64 + std::countr_zero(bits)));
+                        }
+                    }
+                    break;
+                default:
+                    for (const Run& r : runs) {
+                        for (std::uint32_t v = r.start; v <= std::uint32_t(r.start) + r.length; ++v) fn(high | v);
+                    }
+                }
+            }
+
+            // 置位 [begin, end)
+            static void setRange(Word* w, std::uint32_t begin, std::uint32_t end) noexcept
+            {
+                for (std::uint32_t i = begin; i < end;) {
+                    const std::uint32_t bit = i % 64;
+                    const std::uint32_t count = std::min<std::uint32_t>(64 - bit, end - i);
+                    const Word mask = count == 64 ? ~Word(0) : ((Word(1) << count) - 1) << bit;
+                    w[i / 64] |= mask;
+                    i += count;
+                }
+            }
+
+            // 从from开始第一个值为set的位，没有则返回65536
+            static std::uint32_t nextBit(const Word* w, std::uint32_t from, bool set) noexcept
+            {
+                std::size_t i = from / 64;
+                Word bits = (set ? w[i] : ~w[i]) & (~Word(0) << (from % 64));
+                while (bits == 0) {
+                    if (++i == BitmapWords) return BitmapWords * 64;
+                    bits = set ? w[i] : ~w[i];
+                }
+                return static_cast<std::uint32_t>(i * 64 + std::countr_zero(bits));
+            }
+        };
+
+        // 两侧展开成字后按字运算
+        template<Op op>
+        Container wordOp(const Container& a, const Container& b)
+        {
+            alignas(64) static thread_local Word scratch[BitmapWords];
+            Words result(BitmapWords);
+            a.toWords(result.data());
+            Item06_DynamicBitset::Detail::apply<op>(result.data(), b.words(scratch), BitmapWords);
+            const auto card = static_cast<std::uint32_t>(Item06_DynamicBitset::Detail::popcount(result.data(), BitmapWords));
+            return Container::fromWords(std::move(result), card);
+        }
+
+        inline Container intersect(const Container& a, const Container& b)
+        {
+            using Kind = Container::Kind;
+            if (a.kind == Kind::Array && b.kind == Kind::Array) {
+                std::vector<std::uint16_t> out;
+                out.reserve(std::min(a.array.size(), b.array.size()));
+                std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(out));
+                return Container::fromArray(std::move(out));
+            }
+            if (a.kind == Kind::Array || b.kind == Kind::Array) {
+                const Container& small = a.kind == Kind::Array ? a : b;
+                const Container& other = a.kind == Kind::Array ? b : a;
+                std::vector<std::uint16_t> out;
+                for (std::uint16_t v : small.array) {
+                    if (other.contains(v)) out.push_back(v);
+                }
+                return Container::fromArray(std::move(out));
+            }
+            return wordOp<Op::And>(a, b);
+        }
+
+        inline Container unite(const Container& a, const Container& b)
+        {
+            using Kind = Container::Kind;
+            if (a.kind == Kind::Array && b.kind == Kind::Array) {
+                std::vector<std::uint16_t> out;
+                out.reserve(a.array.size() + b.array.size());
+                std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(out));
+                return Container::fromArray(std::move(out));
+            }
+            return wordOp<Op::Or>(a, b);
+        }
+
+        inline Container subtract(const Container& a, const Container& b)
+        {
+            if (a.kind == Container::Kind::Array) {
+                std::vector<std::uint16_t> out;
+                if (b.kind == Container::Kind::Array) {
+                    std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(out));
+                }
+                else {
+                    for (std::uint16_t v : a.array) {
+                        if (!b.contains(v)) out.push_back(v);
+                    }
+                }
+                return Container::fromArray(std::move(out));
+            }
+            return wordOp<Op::AndNot>(a, b);
+        }
+
+        // [begin, end)中置位的个数：首尾两个字用掩码，中间的整字交给AVX2 popcount
+        inline std::uint64_t rangeCount(const Word* w, std::uint32_t begin, std::uint32_t end) noexcept
+        {
+            const std::uint32_t first = begin / 64, last = (end - 1) / 64;
+            const Word headMask = ~Word(0) << (begin % 64);
+            const Word tailMask = ~Word(0) >> (63 - (end - 1) % 64);
+            if (first == last) return static_cast<std::uint64_t>(std::popcount(w[first] & headMask & tailMask));
+
+            return static_cast<std::uint64_t>(std::popcount(w[first] & headMask))
+                 + Item06_DynamicBitset::Detail::popcount(w + first + 1, last - first - 1)
+                 + static_cast<std::uint64_t>(std::popcount(w[last] & tailMask));
+        }
+
+        // 两组有序区间的重叠长度之和
+        inline std::uint64_t runOverlap(const std::vector<Run>& a, const std::vector<Run>& b) noexcept
+        {
+            std::uint64_t n = 0;
+            for (std::size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+                const std::uint32_t aEnd = std::uint32_t(a[i].start) + a[i].length;
+                const std::uint32_t bEnd = std::uint32_t(b[j].start) + b[j].length;
+                const std::uint32_t lo = std::max(a[i].start, b[j].start);
+                const std::uint32_t hi = std::min(aEnd, bEnd);
+                if (lo <= hi) n += hi - lo + 1;
+                if (aEnd < bEnd) ++i;
+                else ++j;
+            }
+            return n;
+        }
+
+        // |a ∩ b|，不构造结果
+        inline std::uint64_t intersectCount(const Container& a, const Container& b)
+        {
+            using Kind = Container::Kind;
+            if (a.kind == Kind::Array && b.kind == Kind::Array) {
+                std::uint64_t n = 0;
+                for (auto i = a.array.begin(), j = b.array.begin(); i != a.array.end() && j != b.array.end();) {
+                    if (*i < *j) ++i;
+                    else if (*j < *i) ++j;
+                    else { ++n; ++i; ++j; }
+                }
+                return n;
+            }
+            if (a.kind == Kind::Array || b.kind == Kind::Array) {
+                const Container& small = a.kind == Kind::Array ? a : b;
+                const Container& other = a.kind == Kind::Array ? b : a;
+                std::uint64_t n = 0;
+                for (std::uint16_t v : small.array) n += other.contains(v);
+                return n;
+            }
+            if (a.kind == Kind::Run && b.kind == Kind::Run) return runOverlap(a.runs, b.runs);
+            if (a.kind == Kind::Run || b.kind == Kind::Run) {
+                // 区间与位图：只数区间覆盖的那些字，不展开区间
+                const Container& run = a.kind == Kind::Run ? a : b;
+                const Container& other = a.kind == Kind::Run ? b : a;
+                if (run.card == BitmapWords * 64) return other.card;
+                std::uint64_t n = 0;
+                for (const Run& r : run.runs) n += rangeCount(other.bitmap.data(), r.start, std::uint32_t(r.start) + r.length + 1);
+                return n;
+            }
+            return Item06_DynamicBitset::Detail::popcount<Op::And>(a.bitmap.data(), b.bitmap.data(), BitmapWords);
+        }
+    }
+
+
+    // 二、位图
+    class RoaringBitmap
+    {
+    public:
+        RoaringBitmap() = default;
+
+        void add(std::uint32_t x)
+        {
+            const auto high = static_cast<std::uint16_t>(x >> 16);
+            const auto low = static_cast<std::uint16_t>(x & 0xffff);
+
+            // 递增添加时总是落在最后一个容器
+            if (!keys.empty() && keys.back() == high) {
+                containers.back().add(low);
+                return;
+            }
+            auto it = std::lower_bound(keys.begin(), keys.end(), high);
+            const auto index = static_cast<std::size_t>(it - keys.begin());
+            if (it == keys.end() || *it != high) {
+                keys.insert(it, high);
+                containers.insert(containers.begin() + static_cast<std::ptrdiff_t>(index), Detail::Container{});
+            }
+            containers[index].add(low);
+        }
+
+        bool contains(std::uint32_t x) const noexcept
+        {
+            const auto high = static_cast<std::uint16_t>(x >> 16);
+            auto it = std::lower_bound(keys.begin(), keys.end(), high);
+            if (it == keys.end() || *it != high) return false;
+            return containers[static_cast<std::size_t>(it - keys.begin())].contains(static_cast<std::uint16_t>(x & 0xffff));
+        }
+
+        std::uint64_t cardinality() const noexcept
+        {
+            std::uint64_t n = 0;
+            for (const auto& c : containers) n += c.card;
+            return n;
+        }
+
+        bool empty() const noexcept { return containers.empty(); }
+
+        // 把区间更省空间的容器转成Run，返回转换的容器数
+        std::size_t run_optimize()
+        {
+            std::size_t converted = 0;
+            for (auto& c : containers) converted += c.runOptimize();
+            return converted;
+        }
+
+        // 容器内容占用的字节数（不含vector自身的管理开销）
+        std::size_t size_in_bytes() const noexcept
+        {
+            std::size_t bytes = keys.size() * sizeof(std::uint16_t);
+            for (const auto& c : containers) bytes += c.bytes();
+            return bytes;
+        }
+
+        // 按递增顺序对每个元素调用fn(std::uint32_t)
+        template<typename F>
+        void for_each(F fn) const
+        {
+            for (std::size_t i = 0; i < keys.size(); ++i) containers[i].forEach(std::uint32_t(keys[i]) << 16, fn);
+        }
+
+        friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b)
+        {
+            RoaringBitmap result;
+            matchKeys(a, b, [&](std::size_t i, std::size_t j) {
+                result.append(a.keys[i], Detail::intersect(a.containers[i], b.containers[j]));
+            }, nullptr, nullptr);
+            return result;
+        }
+
+        friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b)
+        {
+            RoaringBitmap result;
+            matchKeys(a, b,
+                [&](std::size_t i, std::size_t j) { result.append(a.keys[i], Detail::unite(a.containers[i], b.containers[j])); },
+                [&](std::size_t i) { result.append(a.keys[i], Detail::Container(a.containers[i])); },
+                [&](std::size_t j) { result.append(b.keys[j], Detail::Container(b.containers[j])); });
+            return result;
+        }
+
+        // a中有、b中没有
+        friend RoaringBitmap andnot(const RoaringBitmap& a, const RoaringBitmap& b)
+        {
+            RoaringBitmap result;
+            matchKeys(a, b,
+                [&](std::size_t i, std::size_t j) { result.append(a.keys[i], Detail::subtract(a.containers[i], b.containers[j])); },
+                [&](std::size_t i) { result.append(a.keys[i], Detail::Container(a.containers[i])); },
+                nullptr);
+            return result;
+        }
+
+        // 只计数，不构造结果
+        friend std::uint64_t and_cardinality(const RoaringBitmap& a, const RoaringBitmap& b)
+        {
+            std::uint64_t n = 0;
+            matchKeys(a, b, [&](std::size_t i, std::size_t j) {
+                n += Detail::intersectCount(a.containers[i], b.containers[j]);
+            }, nullptr, nullptr);
+            return n;
+        }
+
+        friend std::uint64_t or_cardinality(const RoaringBitmap& a, const RoaringBitmap& b)
+        {
+            return a.cardinality() + b.cardinality() - and_cardinality(a, b);
+        }
+
+        friend std::uint64_t andnot_cardinality(const RoaringBitmap& a, const RoaringBitmap& b)
+        {
+            return a.cardinality() - and_cardinality(a, b);
+        }
+
+    private:
+        // 结果为空的容器不保存
+        void append(std::uint16_t key, Detail::Container&& c)
+        {
+            if (c.card == 0) return;
+            keys.push_back(key);
+            containers.push_back(std::move(c));
+        }
+
+        // 按键归并两个位图：both(i, j)处理两边都有的块，onlyA(i)、onlyB(j)处理只在一边的块（可以为nullptr）
+        template<typename Both, typename OnlyA, typename OnlyB>
+        static void matchKeys(const RoaringBitmap& a, const RoaringBitmap& b, Both both, OnlyA onlyA, OnlyB onlyB)
+        {
+            std::size_t i = 0, j = 0;
+            while (i < a.keys.size() && j < b.keys.size()) {
+                if (a.keys[i] < b.keys[j]) {
+                    if constexpr (!std::is_null_pointer_v<OnlyA>) onlyA(i);
+                    ++i;
+                }
+                else if (b.keys[j] < a.keys[i]) {
+                    if constexpr (!std::is_null_pointer_v<OnlyB>) onlyB(j);
+                    ++j;
+                }
+                else {
+                    both(i++, j++);
+                }
+            }
+            if constexpr (!std::is_null_pointer_v<OnlyA>) for (; i < a.keys.size(); ++i) onlyA(i);
+            if constexpr (!std::is_null_pointer_v<OnlyB>) for (; j < b.keys.size(); ++j) onlyB(j);
+        }
+
+        std::vector<std::uint16_t> keys;                // 递增
+        std::vector<Detail::Container> containers;
+    };
+
+
+    // 三、按特征分列的索引
+    namespace Example
+    {
+        class Widget
+        {
+        public:
+            explicit Widget(std::uint64_t flags = 0) : flags(flags) {}
+
+            bool hasFeature(std::size_t k) const noexcept { return (flags >> k) & 1; }
+            std::uint64_t featureMask() const noexcept { return flags; }
+
+        private:
+            std::uint64_t flags;
+        };
+    }
+
+    class FeatureIndex
+    {
+    public:
+        static constexpr std::size_t MaxFeatures = 64;
+
+        // 第i个Widget的编号为i；建完后对每列做run_optimize
+        explicit FeatureIndex(std::span<const Example::Widget> widgets) : columns(MaxFeatures)
+        {
+            for (std::size_t i = 0; i < widgets.size(); ++i) {
+                for (std::uint64_t mask = widgets[i].featureMask(); mask != 0; mask &= mask - 1) {
+                    columns[static_cast<std::size_t>(std::countr_zero(mask))].add(static_cast<std::uint32_t>(i));
+                }
+            }
+            for (auto& column : columns) column.run_optimize();
+        }
+
+        const RoaringBitmap& column(std::size_t k) const noexcept { return columns[k]; }
+
+        std::size_t size_in_bytes() const noexcept
+        {
+            std::size_t bytes = 0;
+            for (const auto& column : columns) bytes += column.size_in_bytes();
+            return bytes;
+        }
+
+    private:
+        std::vector<RoaringBitmap> columns;
+    };
+
+    inline void test()
+    {
+        using Example::Widget;
+
+        std::vector<Widget> widgets;
+        for (std::uint64_t i = 0; i < 200000; ++i) widgets.emplace_back(i % 7 == 0 ? 0b100100 : (i < 100000 ? 0b000100 : 0));
+
+        FeatureIndex index(widgets);
+
+        // 有特征5、没有特征2的Widget
+        RoaringBitmap hits = andnot(index.column(5), index.column(2));
+        std::uint64_t n = andnot_cardinality(index.column(5), index.column(2));     // 只计数
+
+        hits.for_each([](std::uint32_t widget) {
+            // 处理编号为widget的Widget
+            (void)widget;
+        });
+
+        (void)n;
+    }
+}
+
+// 总结
+// * "哪些Widget有某些特征"是按列的查询：按特征分列存放，查询就是列之间的位运算
+// * 按密度为每一块选容器：稀疏用数组、稠密用位图、成段用区间，大小都不超过8KB
+// * 只需要个数时不要构造结果：运算和popcount融合在一个循环里
@@ -260,6 +260,8 @@ namespace {
 
         // 标准库函数std::make_unique和std::make_shared（参见Item21）也面临该问题
     }
+
+    // 把括号的选择交给调用者、并从arena分配的版本见item07_arena.hpp：arena.make<T, Init::Brace>(args...)
 } // namespace
 
 // 七、总结
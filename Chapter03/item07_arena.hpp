@@ -0,0 +1,307 @@
+/* 条款7 扩展 - 用单调分配区实现doSomeWork：arena.make<T>(args...)，一次性整体释放 */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item07.cpp中的doSomeWork本应是：
+        return new T(std::forward<Args>(args)...);
+    处理一个请求时往往要创建几十上百个这样的小对象，请求结束时再逐个delete。
+    每个对象都要经过一次全局分配器，而它们的生命周期其实完全相同：随请求开始，随请求结束。
+
+    Arena（单调分配区）为这种场景而设：
+    * 从大块内存中顺序"切"出对象，分配只是移动一个指针；单个对象不能释放
+    * reset()一次性释放所有对象：平凡析构的对象什么都不用做，O(1)；
+      非平凡析构的对象在构造成功后登记在一个链表中（记录也分配在arena里），reset()时逆序析构
+    * reset()保留已经申请的内存块，下一个请求直接复用，稳定状态下不再访问全局分配器
+    * 块大小从initialBlock起按2倍增长，不超过maxBlock；超过块大小的对象单独占一块
+
+    arena.make<T>(args...)与doSomeWork的转发签名相同，括号由调用者在编译期选择：
+        arena.make<std::vector<int>>(10, 20);                 // 圆括号（默认，与make_unique一致）：10个元素
+        arena.make<std::vector<int>, Init::Brace>(10, 20);    // 花括号：2个元素
+    这正是条款7的结论——只有调用者知道想要哪一个，模板作者把选择权交给调用者。
+
+    对象中的容器默认仍从全局分配器分配，可以改用Allocator<T>让它们也落在arena里：
+        using Ints = std::vector<int, Allocator<int>>;
+        arena.make<Ints>(10, 20, arena.allocator<int>());
+
+    注意：
+    * make返回的裸指针只在下一次reset()（或arena析构）之前有效，不要delete它
+    * Arena不可拷贝、不可移动（已发出的指针指向它的内存块），也不是线程安全的：一个请求一个arena
+*/
+
+namespace Item07_Arena
+{
+    // 一、括号的选择
+    enum class Init
+    {
+        Paren,      // T(args...)
+        Brace       // T{args...}
+    };
+
+    template<typename T>
+    class Allocator;
+
+
+    // 二、单调分配区
+    class Arena
+    {
+    public:
+        static constexpr std::size_t DefaultInitialBlock = 4 * 1024;
+        static constexpr std::size_t DefaultMaxBlock = 1024 * 1024;
+
+        explicit Arena(std::size_t initialBlock = DefaultInitialBlock, std::size_t maxBlock = DefaultMaxBlock)
+            : nextBlockSize(std::max<std::size_t>(initialBlock, 256)),
+              maxBlockSize(std::max(maxBlock, nextBlockSize))
+        {
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena()
+        {
+            runDestructors();
+            Block* b = head;
+            while (b != nullptr) {
+                Block* next = b->next;
+                ::operator delete(b, std::align_val_t{ alignof(Block) });
+                b = next;
+            }
+        }
+
+        // 对齐地切出bytes字节，不会返回nullptr（失败时抛出std::bad_alloc）
+        void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+        {
+            std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+            if (cursor == nullptr || p + bytes > reinterpret_cast<std::uintptr_t>(limit)) {
+                p = refill(bytes, alignment);
+            }
+            cursor = reinterpret_cast<std::byte*>(p + bytes);
+            used += bytes;
+            return reinterpret_cast<void*>(p);
+        }
+
+        // 在arena中构造一个T，括号在编译期选择
+        template<typename T, Init init = Init::Paren, typename... Args>
+        T* make(Args&&... args)
+        {
+            static_assert(!std::is_array_v<T>, "Arena::make不支持数组类型");
+
+            if constexpr (std::is_trivially_destructible_v<T>) {
+                void* p = allocate(sizeof(T), alignof(T));
+                return construct<T, init>(p, std::forward<Args>(args)...);
+            }
+            else {
+                // 析构记录紧挨在对象前面；构造抛出异常时不登记，空间留到reset()时回收
+                constexpr std::size_t align = std::max(alignof(T), alignof(Finalizer));
+                constexpr std::size_t offset = (sizeof(Finalizer) + alignof(T) - 1) / alignof(T) * alignof(T);
+                auto* raw = static_cast<std::byte*>(allocate(offset + sizeof(T), align));
+                T* obj = construct<T, init>(raw + offset, std::forward<Args>(args)...);
+
+                auto* node = ::new (raw) Finalizer{ finalizers, &destroy<T>, obj };
+                finalizers = node;
+                return obj;
+            }
+        }
+
+        template<typename T>
+        Allocator<T> allocator() noexcept;
+
+        // 析构所有对象，回到第一个块的开头；内存块保留下来供下一个请求使用
+        void reset() noexcept
+        {
+            runDestructors();
+            current = head;
+            cursor = head == nullptr ? nullptr : head->data();
+            limit = head == nullptr ? nullptr : head->end();
+            used = 0;
+        }
+
+        // 切出去的字节数（不含对齐填充）
+        std::size_t bytesUsed() const noexcept { return used; }
+
+        // 从全局分配器申请的总字节数
+        std::size_t bytesReserved() const noexcept { return reserved; }
+
+    private:
+        struct alignas(std::max_align_t) Block
+        {
+            Block* next;
+            std::size_t size;           // data()之后可用的字节数
+
+            std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+            std::byte* end() noexcept { return data() + size; }
+        };
+
+        struct Finalizer
+        {
+            Finalizer* next;
+            void (*destroy)(void*) noexcept;
+            void* object;
+        };
+
+        template<typename T>
+        static void destroy(void* p) noexcept
+        {
+            static_cast<T*>(p)->~T();
+        }
+
+        template<typename T, Init init, typename... Args>
+        static T* construct(void* p, Args&&... args)
+        {
+            if constexpr (init == Init::Paren) {
+                return ::new (p) T(std::forward<Args>(args)...);
+            }
+            else {
+                return ::new (p) T{ std::forward<Args>(args)... };
+            }
+        }
+
+        // 链表头是最后构造的对象，正好逆序析构
+        void runDestructors() noexcept
+        {
+            for (Finalizer* f = finalizers; f != nullptr; f = f->next) f->destroy(f->object);
+            finalizers = nullptr;
+        }
+
+        // 当前块放不下：先复用reset()之前留下的后续块，都不够大时再申请新块插在当前块之后
+        std::uintptr_t refill(std::size_t bytes, std::size_t alignment)
+        {
+            const std::size_t need = bytes + alignment;
+            Block* next = current == nullptr ? head : current->next;
+            while (next != nullptr && next->size < need) next = next->next;
+
+            if (next == nullptr) {
+                const std::size_t size = std::max(nextBlockSize, need);
+                nextBlockSize = std::min(nextBlockSize * 2, maxBlockSize);
+
+                next = static_cast<Block*>(::operator new(sizeof(Block) + size, std::align_val_t{ alignof(Block) }));
+                next->size = size;
+                reserved += sizeof(Block) + size;
+
+                if (current == nullptr) {
+                    next->next = head;
+                    head = next;
+                }
+                else {
+                    next->next = current->next;
+                    current->next = next;
+                }
+            }
+
+            // 跳过的较小的块这一轮不再使用，reset()后重新参与
+            current = next;
+            cursor = next->data();
+            limit = next->end();
+            return (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+        }
+
+        Block* head = nullptr;
+        Block* current = nullptr;
+        std::byte* cursor = nullptr;
+        std::byte* limit = nullptr;
+        Finalizer* finalizers = nullptr;
+
+        std::size_t nextBlockSize;
+        std::size_t maxBlockSize;
+        std::size_t used = 0;
+        std::size_t reserved = 0;
+    };
+
+
+    // 三、让对象内部的容器也从arena分配：deallocate什么都不做，内存在reset()时统一回收
+    template<typename T>
+    class Allocator
+    {
+    public:
+        using value_type = T;
+
+        explicit Allocator(Arena& arena) noexcept : arena(&arena) {}
+
+        template<typename U>
+        Allocator(const Allocator<U>& other) noexcept : arena(other.arena) {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n > static_cast<std::size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+            return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) noexcept {}
+
+        template<typename U>
+        friend bool operator==(const Allocator& a, const Allocator<U>& b) noexcept { return a.arena == b.arena; }
+
+    private:
+        template<typename> friend class Allocator;
+
+        Arena* arena;
+    };
+
+    template<typename T>
+    Allocator<T> Arena::allocator() noexcept
+    {
+        return Allocator<T>(*this);
+    }
+
+
+    // 四、一个请求内的对象图
+    namespace Example
+    {
+        struct Header
+        {
+            std::string name;
+            std::string value;
+        };
+
+        struct Request
+        {
+            int id = 0;
+            std::vector<Header*> headers;
+            std::vector<int>* params = nullptr;
+        };
+
+        // 与item07.cpp中的doSomeWork相同的签名，只是对象来自arena
+        template<typename T, Init init = Init::Paren, typename... Args>
+        T* doSomeWork(Arena& arena, Args&&... args)
+        {
+            return arena.make<T, init>(std::forward<Args>(args)...);
+        }
+    }
+
+    inline void test()
+    {
+        using namespace Example;
+
+        Arena arena;
+
+        auto* v1 = doSomeWork<std::vector<int>>(arena, 10, 20);                 // 10个元素，值都是20
+        auto* v2 = doSomeWork<std::vector<int>, Init::Brace>(arena, 10, 20);    // 2个元素：10和20
+
+        auto* request = arena.make<Request>();
+        request->id = 1;
+        request->headers.push_back(arena.make<Header, Init::Brace>("Host", "example.com"));
+        request->params = v2->size() == 2 ? v2 : v1;
+
+        using Ints = std::vector<int, Allocator<int>>;
+        auto* local = arena.make<Ints>(10, 20, arena.allocator<int>());         // 元素也在arena中
+        local->push_back(30);
+
+        arena.reset();                  // 逆序析构local、request、v2、v1，内存块留给下一个请求
+    }
+}
+
+// 总结
+// * 模板作者无法替调用者决定用圆括号还是花括号，把选择做成编译期参数：make<T, Init::Brace>
+// * 生命周期相同的一组对象适合放进同一个arena：分配是移动指针，释放是整体回到起点
+// * 平凡析构的对象图reset()是O(1)；非平凡析构的对象按构造的逆序逐个析构
@@ -0,0 +1,421 @@
+/* 条款7 扩展 - 线程缓存的对象池：回收doSomeWork创建的对象 */
+
+#pragma once
+
+#include "item07_arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*
+    item07.cpp中doSomeWork的 new T(...) 对长期存在、但频繁创建销毁的对象来说是malloc的热点。
+    item07_arena.hpp的整体释放不适合这种对象：它们一个一个地死去，不会在同一时刻一起释放。
+
+    object_pool<T>只管理固定大小的槽位，把释放的槽位留给下一次创建：
+    * 每个线程有自己的空闲链表，创建和销毁通常只是链表头的出入栈，不加锁、没有原子读改写
+    * 本线程空闲链表超过2个批次时，把一个批次交给全局仓库（depot）；空了再从仓库取回一个批次，
+      仓库也空时一次从大块内存中切出一个批次。加锁的次数是操作次数的 1/批次大小
+    * 线程退出时把自己的空闲槽位全部交还仓库；在A线程创建、B线程销毁也可以，槽位进入B的链表
+    * make(args...)返回handle（std::unique_ptr），删除器把对象析构后还给池；
+      括号的选择与Arena::make相同：make<Init::Brace>(args...)
+    * stats()给出当前存活、峰值存活、已切出的槽位数：
+      存活计数由各线程批量汇总到全局；每个线程还记下自上次汇总以来本地计数的最高点，汇总时和stats()中
+      以"汇总前的全局存活 + 本地最高点"更新峰值。单线程时峰值是精确的；多个线程的短暂高点互相错开时，
+      峰值最多少算 (线程数 - 1) × 批次大小
+
+    注意：池必须比它创建的所有handle活得久；槽位内存只在池（以及仍持有缓存的线程）全部结束后才归还系统。
+    池可以是静态存储期的（全局或函数内的static）：它在程序退出时析构，晚于主线程的线程局部缓存，
+    所以析构函数不访问线程局部数据，此后对池的操作也绕过已经析构的缓存，直接使用仓库。
+*/
+
+namespace Item07_ObjectPool
+{
+    using Item07_Arena::Init;
+
+    struct Stats
+    {
+        std::int64_t live = 0;          // 当前存活的对象
+        std::int64_t peak = 0;          // 存活对象的峰值
+        std::size_t capacity = 0;       // 已切出的槽位数（存活 + 空闲）
+        std::size_t depot = 0;          // 仓库中的空闲槽位数
+    };
+
+    template<typename T>
+    class object_pool
+    {
+    public:
+        struct Deleter
+        {
+            object_pool* pool = nullptr;
+
+            void operator()(T* p) const noexcept { pool->destroy(p); }
+        };
+
+        using handle = std::unique_ptr<T, Deleter>;
+
+        explicit object_pool(std::size_t batchSize = 32) : core(std::make_shared<Core>(std::max<std::size_t>(batchSize, 1))) {}
+
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        // 不访问线程局部的locals：静态存储期的池析构时，主线程的locals可能已经析构。
+        // 各线程的缓存（包括本线程）在线程退出或下次访问任一object_pool<T>时清理，Core随最后一个缓存释放
+        ~object_pool()
+        {
+            core->closed.store(true, std::memory_order_release);
+        }
+
+        template<Init init = Init::Paren, typename... Args>
+        handle make(Args&&... args)
+        {
+            return handle(create<init>(std::forward<Args>(args)...), Deleter{ this });
+        }
+
+        // 不经过handle的版本：必须配对调用destroy
+        template<Init init = Init::Paren, typename... Args>
+        T* create(Args&&... args)
+        {
+            Cache* cache = localCache();
+            Slot* slot = cache != nullptr ? cache->pop() : core->takeOne();
+            try {
+                T* p;
+                if constexpr (init == Init::Paren) {
+                    p = ::new (slot->storage) T(std::forward<Args>(args)...);
+                }
+                else {
+                    p = ::new (slot->storage) T{ std::forward<Args>(args)... };
+                }
+                if (cache != nullptr) cache->count(+1);
+                else core->addLive(+1, 1);
+                return p;
+            }
+            catch (...) {
+                if (cache != nullptr) cache->push(slot);
+                else core->giveOne(slot);
+                throw;
+            }
+        }
+
+        void destroy(T* p) noexcept
+        {
+            if (p == nullptr) return;
+            p->~T();
+            Cache* cache = localCache();
+            if (cache != nullptr) {
+                cache->push(reinterpret_cast<Slot*>(p));
+                cache->count(-1);
+            }
+            else {
+                core->giveOne(reinterpret_cast<Slot*>(p));
+                core->addLive(-1, 0);
+            }
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            std::lock_guard lock(core->mutex);
+            const std::int64_t folded = core->live.load(std::memory_order_relaxed);
+            s.live = folded;
+            s.peak = core->peak.load(std::memory_order_relaxed);
+            for (const Cache* c : core->caches) {
+                s.live += c->delta.load(std::memory_order_relaxed);
+                s.peak = std::max(s.peak, folded + c->localMax.load(std::memory_order_relaxed));
+            }
+            s.peak = std::max(s.peak, s.live);
+            s.capacity = core->carved;
+            for (const Batch& b : core->depot) s.depot += b.count;
+            return s;
+        }
+
+    private:
+        union Slot
+        {
+            Slot* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        struct Batch
+        {
+            Slot* head;
+            std::size_t count;
+        };
+
+        struct Cache;
+
+        // 所有线程共享的部分：仓库、大块内存、全局计数
+        struct Core
+        {
+            explicit Core(std::size_t batchSize) : batchSize(batchSize) {}
+
+            ~Core()
+            {
+                for (Slot* chunk : chunks) ::operator delete(chunk, std::align_val_t{ alignof(Slot) });
+            }
+
+            // 调用时已持有mutex
+            Batch carve()
+            {
+                if (chunkCursor == chunkEnd) {
+                    const std::size_t slots = batchSize * 64;
+                    chunkCursor = static_cast<Slot*>(::operator new(slots * sizeof(Slot), std::align_val_t{ alignof(Slot) }));
+                    chunkEnd = chunkCursor + slots;
+                    chunks.push_back(chunkCursor);
+                }
+                Slot* first = chunkCursor;
+                for (std::size_t i = 0; i + 1 < batchSize; ++i) first[i].next = &first[i + 1];
+                first[batchSize - 1].next = nullptr;
+                chunkCursor += batchSize;
+                carved += batchSize;
+                return Batch{ first, batchSize };
+            }
+
+            // delta：自上次汇总以来的净变化；localMax：这期间净变化的最高点
+            void addLive(std::int64_t delta, std::int64_t localMax) noexcept
+            {
+                const std::int64_t before = live.fetch_add(delta, std::memory_order_relaxed);
+                const std::int64_t high = before + std::max(localMax, delta);
+                std::int64_t prev = peak.load(std::memory_order_relaxed);
+                while (high > prev && !peak.compare_exchange_weak(prev, high, std::memory_order_relaxed)) {}
+            }
+
+            // 本线程的缓存已经析构（线程退出阶段）时，逐个槽位直接与仓库交换
+            Slot* takeOne()
+            {
+                std::lock_guard lock(mutex);
+                if (depot.empty()) depot.push_back(carve());
+                Batch& b = depot.back();
+                Slot* s = b.head;
+                b.head = s->next;
+                if (--b.count == 0) depot.pop_back();
+                return s;
+            }
+
+            void giveOne(Slot* s) noexcept
+            {
+                std::lock_guard lock(mutex);
+                if (!depot.empty()) {
+                    s->next = depot.back().head;
+                    depot.back().head = s;
+                    ++depot.back().count;
+                    return;
+                }
+                s->next = nullptr;
+                try {
+                    depot.push_back(Batch{ s, 1 });
+                }
+                catch (...) {
+                    // 仓库扩容失败：这个槽位不再复用，内存随Core一起释放
+                }
+            }
+
+            const std::size_t batchSize;
+
+            mutable std::mutex mutex;
+            std::vector<Batch> depot;
+            std::vector<Slot*> chunks;
+            Slot* chunkCursor = nullptr;
+            Slot* chunkEnd = nullptr;
+            std::size_t carved = 0;
+            std::vector<const Cache*> caches;       // stats()汇总各线程未上交的计数
+
+            std::atomic<std::int64_t> live{ 0 };
+            std::atomic<std::int64_t> peak{ 0 };
+            std::atomic<bool> closed{ false };
+        };
+
+        // 一个线程在一个池中的空闲链表
+        struct Cache
+        {
+            explicit Cache(std::shared_ptr<Core> c) : core(std::move(c))
+            {
+                std::lock_guard lock(core->mutex);
+                core->caches.push_back(this);
+            }
+
+            Cache(const Cache&) = delete;
+            Cache& operator=(const Cache&) = delete;
+
+            // 线程退出或池析构：空闲槽位和未上交的计数全部交还
+            ~Cache()
+            {
+                std::lock_guard lock(core->mutex);
+                try {
+                    if (head != nullptr) core->depot.push_back(Batch{ head, size });
+                }
+                catch (...) {
+                    // 仓库扩容失败：这些槽位不再复用，内存随Core一起释放
+                }
+                core->addLive(delta.load(std::memory_order_relaxed), localMax.load(std::memory_order_relaxed));
+                std::erase(core->caches, this);
+            }
+
+            Slot* pop()
+            {
+                if (head == nullptr) refill();
+                Slot* s = head;
+                head = s->next;
+                --size;
+                return s;
+            }
+
+            void push(Slot* s) noexcept
+            {
+                s->next = head;
+                head = s;
+                if (++size >= 2 * core->batchSize) spill();
+            }
+
+            // 只有本线程写delta和localMax，不需要原子读改写；累计满一个批次再汇总到全局
+            void count(std::int64_t d) noexcept
+            {
+                const std::int64_t v = delta.load(std::memory_order_relaxed) + d;
+                const std::int64_t high = std::max(localMax.load(std::memory_order_relaxed), v);
+                const auto limit = static_cast<std::int64_t>(core->batchSize);
+                if (v >= limit || v <= -limit) {
+                    core->addLive(v, high);
+                    delta.store(0, std::memory_order_relaxed);
+                    localMax.store(0, std::memory_order_relaxed);
+                }
+                else {
+                    delta.store(v, std::memory_order_relaxed);
+                    localMax.store(high, std::memory_order_relaxed);
+                }
+            }
+
+            void refill()
+            {
+                std::lock_guard lock(core->mutex);
+                Batch b;
+                if (!core->depot.empty()) {
+                    b = core->depot.back();
+                    core->depot.pop_back();
+                }
+                else {
+                    b = core->carve();
+                }
+                head = b.head;
+                size = b.count;
+            }
+
+            // 从链表头摘下一个批次交给仓库
+            void spill() noexcept
+            {
+                const std::size_t n = core->batchSize;
+                Slot* first = head;
+                Slot* last = head;
+                for (std::size_t i = 1; i < n; ++i) last = last->next;
+                head = last->next;
+                last->next = nullptr;
+                size -= n;
+
+                std::lock_guard lock(core->mutex);
+                try {
+                    core->depot.push_back(Batch{ first, n });
+                }
+                catch (...) {
+                    // 仓库扩容失败：把批次接回本地链表，下次再试
+                    last->next = head;
+                    head = first;
+                    size += n;
+                }
+            }
+
+            std::shared_ptr<Core> core;
+            Slot* head = nullptr;
+            std::size_t size = 0;
+            std::atomic<std::int64_t> delta{ 0 };
+            std::atomic<std::int64_t> localMax{ 0 };    // 自上次汇总以来delta的最高点
+        };
+
+        // 本线程在各object_pool<T>中的缓存；通常只有一两个池，线性查找即可
+        struct Locals
+        {
+            ~Locals() { localsDestroyed = true; }
+
+            Cache* find(const Core* core) noexcept
+            {
+                if (last != nullptr && last->core.get() == core) return last;
+                for (auto& c : caches) {
+                    if (c->core.get() == core) return last = c.get();
+                }
+                return nullptr;
+            }
+
+            Cache& add(const std::shared_ptr<Core>& core)
+            {
+                // 顺便清理已析构的池留下的缓存
+                std::erase_if(caches, [](const std::unique_ptr<Cache>& c) { return c->core->closed.load(std::memory_order_acquire); });
+                caches.push_back(std::make_unique<Cache>(core));
+                return *(last = caches.back().get());
+            }
+
+            std::vector<std::unique_ptr<Cache>> caches;
+            Cache* last = nullptr;
+        };
+
+        // 线程退出阶段locals析构之后返回nullptr，调用方改为直接与仓库交换
+        Cache* localCache()
+        {
+            if (localsDestroyed) return nullptr;
+            Cache* c = locals.find(core.get());
+            return c != nullptr ? c : &locals.add(core);
+        }
+
+        static inline thread_local Locals locals;
+        static inline thread_local bool localsDestroyed = false;      // 平凡析构，locals析构后仍可读取
+
+        std::shared_ptr<Core> core;
+    };
+
+
+    // 与item07.cpp中的doSomeWork相同的转发签名，对象来自池
+    template<typename T, Init init = Init::Paren, typename... Args>
+    typename object_pool<T>::handle doSomeWork(object_pool<T>& pool, Args&&... args)
+    {
+        return pool.template make<init>(std::forward<Args>(args)...);
+    }
+
+    inline void test()
+    {
+        struct Session
+        {
+            int id;
+            std::vector<int> buffer;
+        };
+
+        struct Message
+        {
+            int id = 0;
+            int kind = 0;
+        };
+
+        object_pool<Session> pool;
+        static object_pool<Message> messages;      // 静态存储期：在主线程的线程局部缓存之后析构
+
+        {
+            auto s1 = pool.make<Init::Brace>(1, std::vector<int>(10, 20));
+            auto s2 = doSomeWork<Session, Init::Brace>(pool, 2, std::vector<int>());
+            s1.reset();                             // 析构，槽位回到本线程的空闲链表
+            auto s3 = pool.make<Init::Brace>(3, std::vector<int>());    // 复用s1的槽位
+            s3->buffer.push_back(s2->id);
+        }
+
+        Stats s = pool.stats();                     // live 0, peak 2, capacity 32（一个批次）
+
+        auto m = messages.make<Init::Brace>(1, 0);  // 用法相同
+        (void)s; (void)m;
+    }
+}
+
+// 总结
+// * 一个个死去的对象用池，一起死去的对象用arena
+// * 热路径只碰本线程的数据；需要共享时按批次交换，锁的开销被批次摊薄
+// * 计数也按批次汇总：统计值允许一点误差，换来热路径上没有原子读改写
@@ -110,6 +110,11 @@ namespace
         return f(pw);                     //调用函数
     }                                     //解锁
 
+    // 高竞争下把多个线程的调用合并执行的版本见item08_flat_combining.hpp：callWithLock(f, fc, pw)
+    // 想知道f1m/f2m/f3m各自的等待和持有时间，把它们换成item08_profiled_mutex.hpp中的profiled_mutex<std::mutex>
+    // f只读Widget时不必加锁：item08_snapshot.hpp中的callWithSnapshot(f, widget)读取不可变的快照
+    // 临界区很短时，item08_adaptive_mutex.hpp中先自旋再休眠的adaptive_mutex可以直接替换std::mutex
+
     void test()
     {
         std::mutex mtx;
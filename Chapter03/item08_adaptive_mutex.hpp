@@ -0,0 +1,137 @@
+/* 条款8 扩展 - 先自旋再休眠的自适应互斥量：callWithLock保护的短临界区 */
+
+#pragma once
+
+#include "item08_flat_combining.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/*
+    callWithLock在item08.cpp中保护的临界区只有几十纳秒，锁的持有者很快就会释放。
+    std::mutex加锁失败时往往直接进入futex系统调用休眠，休眠和唤醒的代价（微秒级）远大于临界区本身。
+
+    adaptive_mutex先在用户态等一会儿，等不到再休眠：
+    * 自旋：反复检查锁是否空闲，两次检查之间执行PAUSE，间隔按指数增长（1、2、4……MaxBackoff次），
+      减少对锁所在缓存行的争抢
+    * 自旋预算有上限；用完仍未得到锁，就把状态标记为"有等待者"，在std::atomic::wait上休眠
+      （Linux上即futex），unlock发现有等待者时notify_one
+    * 预算是自适应的：自旋成功时预算逐渐增加，最终仍要休眠时逐渐减少，趋近于"恰好够用"
+    * 只有一个CPU时自旋毫无意义（持有者不可能同时在运行），预算固定为0
+
+    状态：0 空闲，1 已加锁且没有等待者，2 已加锁且可能有等待者。
+    满足Lockable，可以直接用于callWithLock、std::lock_guard、std::unique_lock：
+        adaptive_mutex f1m;
+        auto result = callWithLock(f1, f1m, nullptr);
+*/
+
+namespace Item08_AdaptiveMutex
+{
+    class adaptive_mutex
+    {
+    public:
+        static constexpr std::uint32_t MaxSpin = 4096;      // PAUSE次数的上限
+        static constexpr std::uint32_t MinSpin = 16;
+        static constexpr std::uint32_t MaxBackoff = 64;
+
+        adaptive_mutex() noexcept : spinBudget(spinAllowed() ? 256 : 0) {}
+
+        adaptive_mutex(const adaptive_mutex&) = delete;
+        adaptive_mutex& operator=(const adaptive_mutex&) = delete;
+
+        bool try_lock() noexcept
+        {
+            std::uint32_t expected = Unlocked;
+            return state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        void lock() noexcept
+        {
+            if (try_lock()) return;
+            if (spin()) return;
+            park();
+        }
+
+        void unlock() noexcept
+        {
+            if (state.exchange(Unlocked, std::memory_order_release) == Contended) state.notify_one();
+        }
+
+    private:
+        static constexpr std::uint32_t Unlocked = 0;
+        static constexpr std::uint32_t Locked = 1;
+        static constexpr std::uint32_t Contended = 2;
+
+        static bool spinAllowed() noexcept
+        {
+            static const bool allowed = std::thread::hardware_concurrency() > 1;
+            return allowed;
+        }
+
+        // 有界的指数退避自旋；成功返回true
+        bool spin() noexcept
+        {
+            const std::uint32_t budget = spinBudget.load(std::memory_order_relaxed);
+            std::uint32_t spent = 0;
+            std::uint32_t backoff = 1;
+            while (spent < budget) {
+                for (std::uint32_t i = 0; i < backoff; ++i) Item08_FlatCombining::Detail::cpuRelax();
+                spent += backoff;
+                backoff = std::min(backoff * 2, MaxBackoff);
+
+                // 先读后写：锁被占用时只读共享的缓存行，不抢它的独占权
+                if (state.load(std::memory_order_relaxed) == Unlocked && try_lock()) {
+                    adapt(std::min(MaxSpin, std::max(MinSpin, spent * 2)));
+                    return true;
+                }
+            }
+            if (budget != 0) adapt(std::max(MinSpin, budget / 2));
+            return false;
+        }
+
+        // 预算向目标值移动1/8，近似于glibc的自适应互斥量；只是一个估计，不需要精确
+        void adapt(std::uint32_t target) noexcept
+        {
+            const std::uint32_t budget = spinBudget.load(std::memory_order_relaxed);
+            const auto next = static_cast<std::int64_t>(budget) + (static_cast<std::int64_t>(target) - static_cast<std::int64_t>(budget)) / 8;
+            spinBudget.store(static_cast<std::uint32_t>(std::clamp<std::int64_t>(next, MinSpin, MaxSpin)), std::memory_order_relaxed);
+        }
+
+        // 标记为有等待者后休眠；醒来时仍以Contended加锁，因为可能还有别的等待者
+        void park() noexcept
+        {
+            std::uint32_t c = state.exchange(Contended, std::memory_order_acquire);
+            while (c != Unlocked) {
+                state.wait(Contended, std::memory_order_relaxed);
+                c = state.exchange(Contended, std::memory_order_acquire);
+            }
+        }
+
+        alignas(64) std::atomic<std::uint32_t> state{ Unlocked };
+        std::atomic<std::uint32_t> spinBudget;
+    };
+
+    inline void test()
+    {
+        struct Widget {};
+
+        adaptive_mutex f3m;
+        auto f3 = [](Widget* pw) { return pw == nullptr; };
+
+        auto callWithLock = [](auto f, auto& mtx, auto pw) {     // 与item08.cpp相同
+            std::lock_guard g(mtx);
+            return f(pw);
+        };
+
+        bool result = callWithLock(f3, f3m, nullptr);     // nullptr推导为std::nullptr_t，再转换为Widget*
+        if (result && f3m.try_lock()) f3m.unlock();        // 已解锁，try_lock成功
+    }
+}
+
+// 总结
+// * 临界区越短，休眠和唤醒在加锁开销中的比例越大：先自旋一小段时间，往往就能等到锁
+// * 自旋要有预算和退避，否则在长临界区或单核上只是在浪费CPU
+// * 比较锁时看延迟分布（p99、p999），而不只是平均值：休眠的代价集中在尾部
@@ -0,0 +1,308 @@
+/* 条款8 扩展 - 平面合并（flat combining）：高竞争下的callWithLock */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/*
+    item08.cpp中的callWithLock每次调用都要加锁：
+        std::lock_guard<Mutex> g(mtx);
+        return f(pw);
+    32个线程同时对同一把锁调用f1/f2/f3时，锁所在的缓存行以及f访问的共享数据在各个核之间来回传递，
+    真正执行f的时间只占很小一部分。
+
+    平面合并把"每个线程自己加锁执行"改成"一个线程替所有人执行"：
+    * 每个线程在FlatCombiner中有一个独占缓存行的槽位，调用时把请求（f、pw和结果的存放位置）发布到槽位中
+    * 抢到锁的线程成为合并者，依次执行所有槽位中待处理的请求，写回结果，再释放锁
+    * 没抢到锁的线程只盯着自己请求上的完成标志（在自己的栈上，不与别人共享），完成后直接返回结果
+    共享数据一直留在合并者的缓存里，锁也只被抢一次，整批请求摊薄了一次缓存行转移的开销。
+
+    接口与callWithLock相同，只是把Mutex换成FlatCombiner：
+        FlatCombiner fc;
+        auto result = callWithLock(f3, fc, nullptr);
+    f抛出的异常会被带回调用线程重新抛出。FlatCombiner同时满足Lockable，
+    item08.cpp中通用的callWithLock（lock_guard版本）和MuxGuard也可以直接使用它，只是那样不会合并。
+
+    注意：
+    * f可能在另一个线程中执行：不要在f中依赖thread_local，也不要在f中再对同一个FlatCombiner调用callWithLock
+    * 请求的执行顺序按槽位而不是按到达顺序
+    * 槽位按线程编号分配，编号在线程退出时回收；超过MaxThreads个线程同时使用时，多出的线程直接加锁执行
+*/
+
+namespace Item08_FlatCombining
+{
+    namespace Detail
+    {
+        // 自旋等待时让出流水线资源给同一核上的另一个超线程
+        inline void cpuRelax() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+            _mm_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        // 线程编号：从0开始紧凑分配，线程退出时归还，保证编号不超过同时存在的线程数
+        class ThreadIds
+        {
+        public:
+            static ThreadIds& instance()
+            {
+                static ThreadIds ids;
+                return ids;
+            }
+
+            unsigned acquire()
+            {
+                std::lock_guard lock(mutex);
+                if (!freeIds.empty()) {
+                    const unsigned id = freeIds.back();
+                    freeIds.pop_back();
+                    return id;
+                }
+                return next++;
+            }
+
+            void release(unsigned id)
+            {
+                std::lock_guard lock(mutex);
+                freeIds.push_back(id);
+            }
+
+        private:
+            std::mutex mutex;
+            std::vector<unsigned> freeIds;
+            unsigned next = 0;
+        };
+
+        inline unsigned threadId()
+        {
+            struct Holder
+            {
+                unsigned id = ThreadIds::instance().acquire();
+                ~Holder() { ThreadIds::instance().release(id); }
+            };
+            static thread_local Holder holder;
+            return holder.id;
+        }
+
+        // 发布到槽位中的请求，放在调用线程的栈上
+        struct RequestBase
+        {
+            void (*run)(RequestBase*) noexcept;
+            std::atomic<bool> done{ false };
+            std::exception_ptr error;
+        };
+
+        // f的返回值：void、引用、值分别保存
+        template<typename R>
+        struct ResultBox
+        {
+            template<typename F>
+            void fill(F&& f) { new (&storage) R(std::forward<F>(f)()); engaged = true; }
+
+            R take() { return std::move(*std::launder(reinterpret_cast<R*>(&storage))); }
+
+            ~ResultBox()
+            {
+                if (engaged) std::launder(reinterpret_cast<R*>(&storage))->~R();
+            }
+
+            alignas(R) unsigned char storage[sizeof(R)];
+            bool engaged = false;
+        };
+
+        template<typename R>
+        struct ResultBox<R&>
+        {
+            template<typename F>
+            void fill(F&& f) { ptr = &std::forward<F>(f)(); }
+
+            R& take() { return *ptr; }
+
+            R* ptr = nullptr;
+        };
+
+        template<>
+        struct ResultBox<void>
+        {
+            template<typename F>
+            void fill(F&& f) { std::forward<F>(f)(); }
+
+            void take() {}
+        };
+
+        template<typename Func, typename Ptr, typename R>
+        struct Request : RequestBase
+        {
+            Request(Func& f, Ptr& pw) : f(f), pw(pw) { run = &invoke; }
+
+            static void invoke(RequestBase* base) noexcept
+            {
+                auto* self = static_cast<Request*>(base);
+                try {
+                    self->result.fill([self]() -> R { return self->f(self->pw); });
+                }
+                catch (...) {
+                    self->error = std::current_exception();
+                }
+            }
+
+            Func& f;
+            Ptr& pw;
+            ResultBox<R> result;
+        };
+    }
+
+
+    // 一、合并器：一把锁 + 每个线程一个槽位
+    class FlatCombiner
+    {
+    public:
+        static constexpr unsigned MaxThreads = 128;
+
+        FlatCombiner() : slots(std::make_unique<Slot[]>(MaxThreads)) {}
+
+        FlatCombiner(const FlatCombiner&) = delete;
+        FlatCombiner& operator=(const FlatCombiner&) = delete;
+
+        // Lockable：让通用的callWithLock和lock_guard也能使用
+        bool try_lock() noexcept
+        {
+            return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+        }
+
+        void lock() noexcept
+        {
+            for (unsigned spins = 0; !try_lock(); ++spins) {
+                if (spins < 64) Detail::cpuRelax();
+                else std::this_thread::yield();
+            }
+        }
+
+        void unlock() noexcept { locked.store(false, std::memory_order_release); }
+
+        // 发布请求并等待完成；抢到锁时顺便执行其他线程的请求
+        void execute(Detail::RequestBase& request)
+        {
+            const unsigned id = Detail::threadId();
+            if (id >= MaxThreads) {
+                std::lock_guard g(*this);
+                request.run(&request);
+                return;
+            }
+
+            // 记录用到过的最大槽位，合并者只扫描到这里；通常只是一次读
+            unsigned limit = activeSlots.load(std::memory_order_relaxed);
+            while (id >= limit && !activeSlots.compare_exchange_weak(limit, id + 1, std::memory_order_relaxed)) {}
+
+            slots[id].request.store(&request, std::memory_order_release);
+            for (unsigned spins = 0; !request.done.load(std::memory_order_acquire); ++spins) {
+                if (try_lock()) {
+                    combine();
+                    unlock();
+                    continue;               // 自己的请求已经发布，combine一定执行过它
+                }
+                if (spins < 64) Detail::cpuRelax();
+                else std::this_thread::yield();
+            }
+        }
+
+        // 合并的批次数和请求数，用于观察平均批次大小
+        std::size_t combinedBatches() const noexcept { return batches.load(std::memory_order_relaxed); }
+        std::size_t combinedRequests() const noexcept { return requests.load(std::memory_order_relaxed); }
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<Detail::RequestBase*> request{ nullptr };
+        };
+
+        // 持有锁时调用：扫描若干遍，直到某一遍没有新请求
+        void combine() noexcept
+        {
+            const unsigned limit = activeSlots.load(std::memory_order_relaxed);
+            std::size_t total = 0;
+            for (int pass = 0; pass < MaxPasses; ++pass) {
+                std::size_t found = 0;
+                for (unsigned i = 0; i < limit; ++i) {
+                    Detail::RequestBase* r = slots[i].request.load(std::memory_order_acquire);
+                    if (r == nullptr) continue;
+                    slots[i].request.store(nullptr, std::memory_order_relaxed);
+                    r->run(r);
+                    r->done.store(true, std::memory_order_release);    // 此后r可能已经析构，不再访问
+                    ++found;
+                }
+                total += found;
+                if (found == 0) break;
+            }
+            batches.fetch_add(1, std::memory_order_relaxed);
+            requests.fetch_add(total, std::memory_order_relaxed);
+        }
+
+        static constexpr int MaxPasses = 4;
+
+        alignas(64) std::atomic<bool> locked{ false };
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<unsigned> activeSlots{ 0 };
+        alignas(64) std::atomic<std::size_t> batches{ 0 };
+        std::atomic<std::size_t> requests{ 0 };
+    };
+
+
+    // 二、与item08.cpp中callWithLock相同的接口
+    template <typename Func, typename Ptr>
+    auto callWithLock(Func f, FlatCombiner& fc, Ptr pw) -> decltype(f(pw))
+    {
+        using R = decltype(f(pw));
+        Detail::Request<Func, Ptr, R> request(f, pw);
+        fc.execute(request);
+        if (request.error) std::rethrow_exception(request.error);
+        return request.result.take();
+    }
+
+    inline void test()
+    {
+        struct Widget
+        {
+            int calls = 0;
+        };
+
+        Widget shared;
+        FlatCombiner fc;
+
+        auto f3 = [&shared](Widget* pw) {
+            ++shared.calls;             // 只有持有锁的合并者会执行这里
+            return pw == nullptr;
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 1000; ++i) callWithLock(f3, fc, nullptr);     // nullptr推导为std::nullptr_t，再转换为Widget*
+            });
+        }
+        for (auto& t : threads) t.join();
+        // shared.calls == 4000
+    }
+}
+
+// 总结
+// * 竞争激烈时，锁的代价主要是缓存行在核之间的转移，而不是临界区本身
+// * 平面合并让一个线程批量执行所有人的临界区：锁和共享数据都留在同一个核上
+// * 接口保持callWithLock(f, mtx, pw)不变，调用方只需换一个"锁"的类型
@@ -0,0 +1,361 @@
+/* 条款8 扩展 - 可剖析的互斥量：callWithLock中各把锁等待了多久、持有了多久 */
+
+#pragma once
+
+#include "item08_flat_combining.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+    item08.cpp中的callWithLock对Mutex是泛型的，f1m、f2m、f3m换成什么锁都可以，
+    但我们看不到调用者在每把锁上等了多久。先测量，再决定改哪把锁：
+
+        profiled_mutex<std::mutex> f1m("f1m");
+        Item08_ProfiledMutex::setEnabled(true);
+        auto result = callWithLock(f1, f1m, nullptr);       // 接口不变
+        Item08_ProfiledMutex::report(std::cout);
+
+    * profiled_mutex<M>满足Lockable，包装任意Lockable的M
+    * 加锁前先try_lock：成功记为无竞争，失败再阻塞加锁并记为有竞争，等待时间为阻塞的时长
+    * 持有时间从加锁成功到unlock
+    * 等待时间和持有时间各记入一个按2的幂分桶的直方图（纳秒），每个线程一份，不与其他线程共享缓存行
+    * report()按总等待时间从大到小列出所有存活的profiled_mutex：最该重新设计的锁排在最前面
+    * 剖析关闭时（默认），lock()只多一次relaxed读，unlock()只多一次普通读
+
+    直方图只给出所在桶的上界，分位数是"不超过"的意思，精度为2倍。
+*/
+
+namespace Item08_ProfiledMutex
+{
+    namespace Detail
+    {
+        inline std::atomic<bool> enabled{ false };
+
+        using Clock = std::chrono::steady_clock;
+
+        inline std::uint64_t now() noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+        }
+
+        // 桶k统计 [2^(k-1), 2^k) 纳秒，桶0统计0纳秒
+        constexpr std::size_t Buckets = 40;
+
+        struct Histogram
+        {
+            void add(std::uint64_t ns) noexcept
+            {
+                const std::size_t k = std::min<std::size_t>(std::bit_width(ns), Buckets - 1);
+                counts[k].fetch_add(1, std::memory_order_relaxed);
+                total.fetch_add(ns, std::memory_order_relaxed);
+                std::uint64_t prev = max.load(std::memory_order_relaxed);
+                while (ns > prev && !max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+            }
+
+            std::array<std::atomic<std::uint64_t>, Buckets> counts{};
+            std::atomic<std::uint64_t> total{ 0 };
+            std::atomic<std::uint64_t> max{ 0 };
+        };
+
+        // 一个线程在一把锁上的记录；线程编号超过槽位数时几个线程共享一份，所以仍用原子加
+        struct alignas(64) ThreadRecord
+        {
+            std::atomic<std::uint64_t> uncontended{ 0 };
+            std::atomic<std::uint64_t> contended{ 0 };
+            std::atomic<std::uint64_t> failedTryLocks{ 0 };
+            Histogram wait;
+            Histogram hold;
+        };
+
+        class Site;
+
+        class Registry
+        {
+        public:
+            static Registry& instance()
+            {
+                static Registry registry;
+                return registry;
+            }
+
+            void add(Site* site)
+            {
+                std::lock_guard lock(mutex);
+                sites.push_back(site);
+            }
+
+            void remove(Site* site)
+            {
+                std::lock_guard lock(mutex);
+                std::erase(sites, site);
+            }
+
+            template<typename F>
+            void forEach(F&& f)
+            {
+                std::lock_guard lock(mutex);
+                for (Site* s : sites) f(*s);
+            }
+
+        private:
+            std::mutex mutex;
+            std::vector<Site*> sites;
+        };
+
+        // 一把具名锁的全部记录，按线程编号分槽，首次使用时分配
+        class Site
+        {
+        public:
+            static constexpr unsigned Slots = 128;
+
+            explicit Site(std::string name) : label(std::move(name)) { Registry::instance().add(this); }
+
+            Site(const Site&) = delete;
+            Site& operator=(const Site&) = delete;
+
+            ~Site()
+            {
+                Registry::instance().remove(this);
+                for (auto& r : records) delete r.load(std::memory_order_relaxed);
+            }
+
+            ThreadRecord& local()
+            {
+                auto& slot = records[Item08_FlatCombining::Detail::threadId() % Slots];
+                ThreadRecord* r = slot.load(std::memory_order_acquire);
+                if (r == nullptr) {
+                    auto fresh = std::make_unique<ThreadRecord>();
+                    if (slot.compare_exchange_strong(r, fresh.get(), std::memory_order_acq_rel)) r = fresh.release();
+                }
+                return *r;
+            }
+
+            template<typename F>
+            void forEachRecord(F&& f) const
+            {
+                for (auto& slot : records) {
+                    if (const ThreadRecord* r = slot.load(std::memory_order_acquire)) f(*r);
+                }
+            }
+
+            void clear()
+            {
+                for (auto& slot : records) {
+                    ThreadRecord* r = slot.load(std::memory_order_acquire);
+                    if (r == nullptr) continue;
+                    r->uncontended.store(0, std::memory_order_relaxed);
+                    r->contended.store(0, std::memory_order_relaxed);
+                    r->failedTryLocks.store(0, std::memory_order_relaxed);
+                    for (Histogram* h : { &r->wait, &r->hold }) {
+                        for (auto& c : h->counts) c.store(0, std::memory_order_relaxed);
+                        h->total.store(0, std::memory_order_relaxed);
+                        h->max.store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            const std::string& name() const noexcept { return label; }
+
+        private:
+            std::string label;
+            std::array<std::atomic<ThreadRecord*>, Slots> records{};
+        };
+    }
+
+
+    // 一、开关：默认关闭
+    inline void setEnabled(bool on) noexcept { Detail::enabled.store(on, std::memory_order_relaxed); }
+    inline bool isEnabled() noexcept { return Detail::enabled.load(std::memory_order_relaxed); }
+
+
+    // 二、可剖析的互斥量
+    template<typename M = std::mutex>
+    class profiled_mutex
+    {
+    public:
+        explicit profiled_mutex(std::string name) : site(std::move(name)) {}
+
+        profiled_mutex(const profiled_mutex&) = delete;
+        profiled_mutex& operator=(const profiled_mutex&) = delete;
+
+        void lock()
+        {
+            if (!Detail::enabled.load(std::memory_order_relaxed)) {
+                m.lock();
+                return;
+            }
+
+            Detail::ThreadRecord& r = site.local();
+            if (m.try_lock()) {
+                acquiredAt = Detail::now();
+                r.uncontended.fetch_add(1, std::memory_order_relaxed);
+                r.wait.add(0);
+                return;
+            }
+
+            const std::uint64_t start = Detail::now();
+            m.lock();
+            acquiredAt = Detail::now();
+            r.contended.fetch_add(1, std::memory_order_relaxed);
+            r.wait.add(acquiredAt - start);
+        }
+
+        bool try_lock()
+        {
+            if (!Detail::enabled.load(std::memory_order_relaxed)) return m.try_lock();
+
+            Detail::ThreadRecord& r = site.local();
+            if (!m.try_lock()) {
+                r.failedTryLocks.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            acquiredAt = Detail::now();
+            r.uncontended.fetch_add(1, std::memory_order_relaxed);
+            r.wait.add(0);
+            return true;
+        }
+
+        // acquiredAt只在持有锁时读写；加锁时剖析关闭则为0，不记录
+        void unlock()
+        {
+            if (acquiredAt != 0) {
+                site.local().hold.add(Detail::now() - acquiredAt);
+                acquiredAt = 0;
+            }
+            m.unlock();
+        }
+
+        const std::string& name() const noexcept { return site.name(); }
+
+        M& native() noexcept { return m; }
+
+    private:
+        M m;
+        std::uint64_t acquiredAt = 0;
+        Detail::Site site;
+    };
+
+
+    // 三、汇总与报告
+    struct Summary
+    {
+        std::string name;
+        std::uint64_t uncontended = 0;
+        std::uint64_t contended = 0;
+        std::uint64_t failedTryLocks = 0;
+        std::array<std::uint64_t, Detail::Buckets> wait{};      // 各桶计数
+        std::array<std::uint64_t, Detail::Buckets> hold{};
+        std::uint64_t waitTotal = 0, waitMax = 0;
+        std::uint64_t holdTotal = 0, holdMax = 0;
+
+        std::uint64_t acquisitions() const noexcept { return uncontended + contended; }
+
+        double contentionRate() const noexcept
+        {
+            return acquisitions() == 0 ? 0.0 : static_cast<double>(contended) / static_cast<double>(acquisitions());
+        }
+
+        // 分位数所在桶的上界（纳秒）
+        static std::uint64_t percentile(const std::array<std::uint64_t, Detail::Buckets>& h, double p) noexcept
+        {
+            std::uint64_t n = 0;
+            for (std::uint64_t c : h) n += c;
+            if (n == 0) return 0;
+            const auto rank = static_cast<std::uint64_t>(p * static_cast<double>(n - 1)) + 1;
+            std::uint64_t seen = 0;
+            for (std::size_t k = 0; k < h.size(); ++k) {
+                seen += h[k];
+                if (seen >= rank) return k == 0 ? 0 : (std::uint64_t(1) << k) - 1;
+            }
+            return ~std::uint64_t(0);
+        }
+    };
+
+    // 所有存活的profiled_mutex，按总等待时间从大到小排列
+    inline std::vector<Summary> snapshot()
+    {
+        std::vector<Summary> result;
+        Detail::Registry::instance().forEach([&](const Detail::Site& site) {
+            Summary s;
+            s.name = site.name();
+            site.forEachRecord([&](const Detail::ThreadRecord& r) {
+                s.uncontended += r.uncontended.load(std::memory_order_relaxed);
+                s.contended += r.contended.load(std::memory_order_relaxed);
+                s.failedTryLocks += r.failedTryLocks.load(std::memory_order_relaxed);
+                for (std::size_t k = 0; k < Detail::Buckets; ++k) {
+                    s.wait[k] += r.wait.counts[k].load(std::memory_order_relaxed);
+                    s.hold[k] += r.hold.counts[k].load(std::memory_order_relaxed);
+                }
+                s.waitTotal += r.wait.total.load(std::memory_order_relaxed);
+                s.holdTotal += r.hold.total.load(std::memory_order_relaxed);
+                s.waitMax = std::max(s.waitMax, r.wait.max.load(std::memory_order_relaxed));
+                s.holdMax = std::max(s.holdMax, r.hold.max.load(std::memory_order_relaxed));
+            });
+            result.push_back(std::move(s));
+        });
+        std::stable_sort(result.begin(), result.end(), [](const Summary& a, const Summary& b) { return a.waitTotal > b.waitTotal; });
+        return result;
+    }
+
+    // 清零所有记录（不影响开关）
+    inline void resetCounters()
+    {
+        Detail::Registry::instance().forEach([](Detail::Site& site) { site.clear(); });
+    }
+
+    inline void report(std::ostream& os)
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-16s %12s %10s %13s %13s %13s %14s %13s %13s\n", "mutex", "acquisitions",
+                      "contended", "wait p50", "wait p99", "wait max", "wait total", "hold p50", "hold p99");
+        os << line;
+        for (const Summary& s : snapshot()) {
+            std::snprintf(line, sizeof(line), "%-16s %12llu %9.1f%% %10llu ns %10llu ns %10llu ns %11.3f ms %10llu ns %10llu ns\n",
+                          s.name.c_str(), static_cast<unsigned long long>(s.acquisitions()), 100.0 * s.contentionRate(),
+                          static_cast<unsigned long long>(Summary::percentile(s.wait, 0.50)),
+                          static_cast<unsigned long long>(Summary::percentile(s.wait, 0.99)),
+                          static_cast<unsigned long long>(s.waitMax), static_cast<double>(s.waitTotal) / 1e6,
+                          static_cast<unsigned long long>(Summary::percentile(s.hold, 0.50)),
+                          static_cast<unsigned long long>(Summary::percentile(s.hold, 0.99)));
+            os << line;
+        }
+    }
+
+    inline void test()
+    {
+        struct Widget {};
+
+        profiled_mutex<std::mutex> f1m("f1m"), f2m("f2m"), f3m("f3m");
+        auto f3 = [](Widget* pw) { return pw == nullptr; };
+
+        auto callWithLock = [](auto f, auto& mtx, auto pw) {     // 与item08.cpp相同
+            std::lock_guard g(mtx);
+            return f(pw);
+        };
+
+        callWithLock(f3, f3m, nullptr);         // 剖析关闭：不记录
+
+        setEnabled(true);
+        callWithLock(f3, f3m, nullptr);         // 记录等待时间和持有时间
+        setEnabled(false);
+
+        std::vector<Summary> summaries = snapshot();    // f3m排在最前：1次无竞争的加锁
+    }
+}
+
+// 总结
+// * 先测量每把锁的竞争率和等待时间，再决定重新设计哪一把
+// * 统计放在线程私有的缓存行里，剖析本身不引入新的竞争
+// * 关闭时只剩一次relaxed读：可以一直留在生产代码中，需要时再打开
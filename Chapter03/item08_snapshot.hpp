@@ -0,0 +1,240 @@
+/* 条款8 扩展 - 读多写少的callWithLock：callWithSnapshot（RCU式快照 + 基于纪元的回收） */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    item08.cpp中f1/f2/f3大多只读Widget的状态，callWithLock却让每次调用都在std::mutex后面排队。
+    读多写少时可以换一种思路：受保护的对象一旦发布就不再修改。
+
+    * Snapshot<T>用一个原子指针指向当前版本；读者取出指针就得到一个不可变的快照，不加锁
+    * 写者复制当前版本、修改副本、再原子地替换指针（写时复制）；写者之间用一把互斥量串行
+    * 被替换下来的旧版本可能还有读者在用，不能立刻delete：基于纪元（epoch）的回收
+      - 全局纪元E单调递增；每个线程有一个独占缓存行的记录，读之前写入当前的E（"钉住"），读完清零
+      - 旧版本在摘下后记下当时的纪元r，再把E加一；之后钉住的读者只会看到新版本
+      - 所有正在读的线程钉住的纪元都大于r时，没有人还能拿着旧版本，可以delete
+    读者的代价：一次seq_cst写（钉住）+ 一次读指针 + 一次release写（解除），没有读改写，读者之间不共享可写的缓存行。
+
+    接口仿照callWithLock(f, mtx, pw)：
+        Snapshot<Widget> widget(Widget{});
+        auto result = callWithSnapshot(f, widget);              // f(const Widget&)，无锁
+        widget.update([](Widget& w) { w.priority = 5; });       // 写时复制
+    f中拿到的引用只在f执行期间有效，不要把它保存下来。
+
+    注意：Snapshot析构时不能再有读者；读者在f中可以再读其他（或同一个）Snapshot。
+*/
+
+namespace Item08_Snapshot
+{
+    namespace Detail
+    {
+        // 每个线程一条记录，串成只增不减的链表；线程退出时标记为空闲，供新线程复用
+        struct alignas(64) Record
+        {
+            std::atomic<std::uint64_t> epoch{ 0 };      // 0表示没有在读
+            std::atomic<bool> inUse{ false };
+            Record* next = nullptr;
+            unsigned depth = 0;                         // 嵌套读取的层数，只由拥有者访问
+        };
+
+        class Epochs
+        {
+        public:
+            // 不析构：其他线程退出时可能晚于静态对象的析构访问它
+            static Epochs& instance()
+            {
+                static Epochs* epochs = new Epochs;
+                return *epochs;
+            }
+
+            std::atomic<std::uint64_t> global{ 1 };
+
+            Record* acquire()
+            {
+                for (Record* r = head.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                    bool expected = false;
+                    if (!r->inUse.load(std::memory_order_relaxed) && r->inUse.compare_exchange_strong(expected, true)) return r;
+                }
+                auto* r = new Record;
+                r->inUse.store(true, std::memory_order_relaxed);
+                r->next = head.load(std::memory_order_relaxed);
+                while (!head.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+                return r;
+            }
+
+            void release(Record* r) noexcept
+            {
+                r->epoch.store(0, std::memory_order_release);
+                r->inUse.store(false, std::memory_order_release);
+            }
+
+            // 正在读的线程中最小的纪元；没有读者时返回UINT64_MAX
+            std::uint64_t minActive() const noexcept
+            {
+                std::uint64_t m = UINT64_MAX;
+                for (Record* r = head.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                    const std::uint64_t e = r->epoch.load(std::memory_order_seq_cst);
+                    if (e != 0 && e < m) m = e;
+                }
+                return m;
+            }
+
+        private:
+            Epochs() = default;
+
+            std::atomic<Record*> head{ nullptr };
+        };
+
+        inline Record& localRecord()
+        {
+            struct Holder
+            {
+                Record* record = Epochs::instance().acquire();
+                ~Holder() { Epochs::instance().release(record); }
+            };
+            static thread_local Holder holder;
+            return *holder.record;
+        }
+
+        // 读期间钉住当前纪元；嵌套时只有最外层真正钉住和解除
+        class Guard
+        {
+        public:
+            Guard() : r(localRecord())
+            {
+                if (r.depth++ == 0) {
+                    // seq_cst：钉住必须在读取指针之前对写者可见
+                    r.epoch.store(Epochs::instance().global.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+                }
+            }
+
+            ~Guard()
+            {
+                if (--r.depth == 0) r.epoch.store(0, std::memory_order_release);
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+        private:
+            Record& r;
+        };
+    }
+
+
+    // 一、受保护的对象
+    template<typename T>
+    class Snapshot
+    {
+    public:
+        template<typename... Args>
+        explicit Snapshot(Args&&... args) : current(new T(std::forward<Args>(args)...)) {}
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        ~Snapshot()
+        {
+            delete current.load(std::memory_order_relaxed);
+        }
+
+        // 在快照上调用f：不加锁
+        template<typename Func>
+        decltype(auto) read(Func&& f) const
+        {
+            Detail::Guard guard;
+            const T* snapshot = current.load(std::memory_order_seq_cst);
+            return std::forward<Func>(f)(*snapshot);
+        }
+
+        // 写时复制：在当前版本的副本上调用mutate，再发布副本
+        template<typename Mutate>
+        void update(Mutate&& mutate)
+        {
+            std::lock_guard lock(writer);
+            auto next = std::make_unique<T>(*current.load(std::memory_order_relaxed));
+            std::forward<Mutate>(mutate)(*next);
+            publish(std::move(next));
+        }
+
+        void store(T value)
+        {
+            std::lock_guard lock(writer);
+            publish(std::make_unique<T>(std::move(value)));
+        }
+
+        // 等待回收的旧版本数
+        std::size_t pendingReclaim() const
+        {
+            std::lock_guard lock(writer);
+            return retired.size();
+        }
+
+    private:
+        struct Retired
+        {
+            std::unique_ptr<const T> object;
+            std::uint64_t epoch;
+        };
+
+        // 调用时已持有writer
+        void publish(std::unique_ptr<T> next)
+        {
+            const T* old = current.exchange(next.release(), std::memory_order_seq_cst);
+            auto& epochs = Detail::Epochs::instance();
+            const std::uint64_t r = epochs.global.fetch_add(1, std::memory_order_seq_cst);
+            retired.push_back(Retired{ std::unique_ptr<const T>(old), r });
+
+            // 钉住的纪元都大于r的旧版本可以回收
+            const std::uint64_t minActive = epochs.minActive();
+            std::erase_if(retired, [minActive](const Retired& x) { return x.epoch < minActive; });
+        }
+
+        std::atomic<const T*> current;
+        mutable std::mutex writer;
+        std::vector<Retired> retired;
+    };
+
+
+    // 二、与callWithLock(f, mtx, pw)对应的读取接口
+    template<typename Func, typename T>
+    decltype(auto) callWithSnapshot(Func f, const Snapshot<T>& snapshot)
+    {
+        return snapshot.read(f);
+    }
+
+    inline void test()
+    {
+        struct Widget
+        {
+            int priority = 0;
+            bool high = false;
+        };
+
+        Snapshot<Widget> widget;
+
+        auto f1 = [](const Widget& w) { return w.high; };
+        bool high = callWithSnapshot(f1, widget);               // 无锁读取
+
+        widget.update([](Widget& w) {                           // 复制、修改、发布
+            w.priority = 5;
+            w.high = true;
+        });
+        high = callWithSnapshot(f1, widget);                    // 之后的读者看到新版本
+
+        widget.store(Widget{});                                 // 整体替换
+        high = callWithSnapshot(f1, widget) || high;
+    }
+}
+
+// 总结
+// * 读多写少时，让读者完全不加锁：对象发布后不可变，写者复制后替换
+// * 难点在于何时释放旧版本：纪元记录"谁可能还在读"，读者只需一次写入就能声明自己的存在
+// * 写者的代价随之上升（复制、分配、扫描各线程的纪元），写比例升高时互斥量会重新占优